@@ -0,0 +1,75 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// adaptive sorting: choose the sorting routine from the size and the shape of the data
+//
+// The measurements of sorting_methods -measure show that no sorting routine is the fastest for all n and all kinds of
+// input data (insertion sort for tiny arrays, tim_sort for presorted data, counting sort for keys in a narrow range,
+// and so on). auto_sort() looks at a small sample of the data (320 items, so it costs about as much as sorting
+// about a hundred items, and nothing if n < AUTO_SORT_MIN_N) to estimate
+//   * the presortedness: the fraction of ascending and of descending adjacent pairs in windows of 4 consecutive items
+//   * the duplicate ratio: the number of distinct keys of a sorted sample
+//   * the key range: the smallest and largest keys of that sample
+// and then uses the first rule of the crossover table for that shape with max_n not smaller than n. The table,
+// auto_sort_table.h, is machine dependent; it is regenerated (and then the program must be compiled again) with
+//   > ./sorting_methods -calibrate > auto_sort_table.h
+//
+
+#include "sorting_methods.h"
+#include "auto_sort_table.h"
+
+#define N_WINDOWS  64  // number of windows of 4 consecutive items (3 adjacent pairs each) for the presortedness
+#define N_SAMPLES  64  // number of sampled items for the duplicate ratio and for the key range
+
+int auto_sort_shape(T *data,int first,int one_after_last)
+{
+  int i,j,n,step,ascending,descending,distinct;
+  T sample[N_SAMPLES];
+
+  n = one_after_last - first;
+  if(n < AUTO_SORT_MIN_N)
+    return AUTO_SORT_RANDOM;
+  //
+  // presortedness (pairs of equal items count neither way, so all equal items are presorted)
+  //
+  step = (n - 4) / (N_WINDOWS - 1);
+  ascending = descending = 0;
+  for(i = 0;i < N_WINDOWS;i++)
+    for(j = first + i * step;j < first + i * step + 3;j++)
+      if(data[j + 1] < data[j])
+        descending++;
+      else if(data[j] < data[j + 1])
+        ascending++;
+  if(10 * descending <= 3 * N_WINDOWS || 10 * ascending <= 3 * N_WINDOWS)
+    return AUTO_SORT_PRESORTED; // at most 10% of the pairs in the wrong direction
+  //
+  // duplicates and key range (the offsets inside each stride vary, so periodic data is not sampled at one phase)
+  //
+  step = n / N_SAMPLES;
+  for(i = 0;i < N_SAMPLES;i++)
+    sample[i] = data[first + i * step + (37 * i) % step];
+  insertion_sort(sample,0,N_SAMPLES);
+  for(i = 1,distinct = 1;i < N_SAMPLES;i++)
+    if(sample[i] != sample[i - 1])
+      distinct++;
+  if(2 * distinct <= N_SAMPLES)
+    return AUTO_SORT_DUPLICATES;
+  if((int64_t)sample[N_SAMPLES - 1] - (int64_t)sample[0] < 2 * (int64_t)n)
+    return AUTO_SORT_NARROW; // the range of the whole array is a little wider, counting_sort() measures it exactly
+  return AUTO_SORT_RANDOM;
+}
+
+void auto_sort(T *data,int first,int one_after_last)
+{
+  int i,n,shape;
+
+  n = one_after_last - first;
+  shape = auto_sort_shape(data,first,one_after_last);
+  for(i = 0;i < (int)(sizeof(auto_sort_rules) / sizeof(auto_sort_rules[0]));i++)
+    if(auto_sort_rules[i].shape == shape && n <= auto_sort_rules[i].max_n)
+    {
+      (*auto_sort_rules[i].function)(data,first,one_after_last);
+      return;
+    }
+  intro_sort(data,first,one_after_last); // incomplete table
+}
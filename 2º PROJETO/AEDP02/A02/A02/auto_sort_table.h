@@ -0,0 +1,19 @@
+//
+// crossover table of auto_sort() (auto_sort.c), generated by ./sorting_methods -calibrate > auto_sort_table.h
+//
+// for each shape, the rules are in increasing order of max_n, and the last one has max_n equal to INT_MAX
+//
+
+#include <limits.h>
+
+static const auto_sort_rule_t auto_sort_rules[] =
+{ // shape                  max_n  function
+  { AUTO_SORT_RANDOM,            24, insertion_sort },
+  { AUTO_SORT_RANDOM,           237, quick_sort_simd },
+  { AUTO_SORT_RANDOM,          1333, bucket_sort },
+  { AUTO_SORT_RANDOM,       INT_MAX, radix_sort },
+  { AUTO_SORT_PRESORTED,    INT_MAX, tim_sort },
+  { AUTO_SORT_DUPLICATES,   INT_MAX, counting_sort },
+  { AUTO_SORT_NARROW,          7499, counting_sort },
+  { AUTO_SORT_NARROW,       INT_MAX, radix_sort },
+};
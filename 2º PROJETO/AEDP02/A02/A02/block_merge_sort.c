@@ -0,0 +1,18 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// stable block merge sort, with O(sqrt(n)) extra memory (see block_merge_sort_template.h)
+//
+
+#include "sorting_methods.h"
+
+#define GT            T
+#define GT_SUFFIX     int
+#define GT_LESS(a,b)  ((a) < (b))
+#include "sorting_methods_template.h"
+#include "block_merge_sort_template.h"
+
+void block_merge_sort(T *data,int first,int one_after_last)
+{
+  block_merge_sort_int(data,first,one_after_last);
+}
@@ -0,0 +1,277 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// type-generic stable block merge sort (in the style of WikiSort, A. Monroe, and of B.-C. Huang and M. Langston, 1992)
+//
+// Like radix_sort_template.h, this file is a "template"; it has to be included after sorting_methods_template.h, with
+// the same GT and GT_SUFFIX.
+//
+// merge_sort() needs a buffer as large as the array. This sort needs only a cache of about sqrt(n) items and about
+// sqrt(n) block tags, and is still stable and O(n log n):
+//   * runs of RUN_SIZE items are sorted by insertion sort, and then merged bottom-up, in place
+//   * two adjacent sorted runs A and B are merged as follows: if A fits in the cache, A is copied to it and merged
+//     with B in the usual way; otherwise, A is split into blocks of about sqrt(|A|) items (the first one may be
+//     smaller), and the A blocks are "rolled" through B: while the smallest remaining A block (the one with the
+//     smallest tag, since A is sorted) does not have to be placed before the last B block that was passed, the
+//     leftmost A block is swapped with the next B block; otherwise that A block is dropped at the right place of the
+//     last B block (binary search and rotation), and the previous dropped A block, which fits in the cache, is merged
+//     with the B items that follow it
+//   * if there is no memory for the cache, two runs are merged by the recursive rotation merge (O(1) extra memory,
+//     but O(n log^2 n) time)
+// Items that compare equal keep their order: in a merge, an item of A is placed before the items of B that are equal
+// to it.
+//
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+//
+// exchange data[a..a+len-1] and data[b..b+len-1] (the two ranges do not overlap)
+//
+static inline void GT_NAME(bms_block_swap)(GT *data,GT_INDEX a,GT_INDEX b,GT_INDEX len)
+{
+  GT tmp;
+
+  while(len-- > 0)
+  {
+    tmp = data[a];
+    data[a++] = data[b];
+    data[b++] = tmp;
+  }
+}
+
+static inline void GT_NAME(bms_reverse)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT tmp;
+
+  while(one_after_last - first > 1)
+  {
+    tmp = data[first];
+    data[first++] = data[--one_after_last];
+    data[one_after_last] = tmp;
+  }
+}
+
+//
+// data[first..middle-1],data[middle..one_after_last-1] becomes data[middle..one_after_last-1],data[first..middle-1]
+//
+static inline void GT_NAME(bms_rotate)(GT *data,GT_INDEX first,GT_INDEX middle,GT_INDEX one_after_last,GT *cache,GT_INDEX cache_size)
+{
+  if(first == middle || middle == one_after_last)
+    return;
+  if(middle - first <= cache_size)
+  {
+    memcpy(cache,&data[first],(size_t)(middle - first) * sizeof(GT));
+    memmove(&data[first],&data[middle],(size_t)(one_after_last - middle) * sizeof(GT));
+    memcpy(&data[first + (one_after_last - middle)],cache,(size_t)(middle - first) * sizeof(GT));
+  }
+  else if(one_after_last - middle <= cache_size)
+  {
+    memcpy(cache,&data[middle],(size_t)(one_after_last - middle) * sizeof(GT));
+    memmove(&data[one_after_last - (middle - first)],&data[first],(size_t)(middle - first) * sizeof(GT));
+    memcpy(&data[first],cache,(size_t)(one_after_last - middle) * sizeof(GT));
+  }
+  else
+  {
+    GT_NAME(bms_reverse)(data,first,middle);
+    GT_NAME(bms_reverse)(data,middle,one_after_last);
+    GT_NAME(bms_reverse)(data,first,one_after_last);
+  }
+}
+
+//
+// index of the first item of data[first..one_after_last-1] that is not smaller than value (one_after_last if none)
+//
+static inline GT_INDEX GT_NAME(bms_binary_first)(GT *data,GT_INDEX first,GT_INDEX one_after_last,GT value)
+{
+  GT_INDEX middle;
+
+  while(first < one_after_last)
+  {
+    middle = first + (one_after_last - first) / 2;
+    if(GT_LESS(data[middle],value))
+      first = middle + 1;
+    else
+      one_after_last = middle;
+  }
+  return first;
+}
+
+//
+// index of the first item of data[first..one_after_last-1] that is larger than value (one_after_last if none)
+//
+static inline GT_INDEX GT_NAME(bms_binary_last)(GT *data,GT_INDEX first,GT_INDEX one_after_last,GT value)
+{
+  GT_INDEX middle;
+
+  while(first < one_after_last)
+  {
+    middle = first + (one_after_last - first) / 2;
+    if(GT_LESS(value,data[middle]))
+      one_after_last = middle;
+    else
+      first = middle + 1;
+  }
+  return first;
+}
+
+//
+// merge data[first..middle-1] (which must fit in the cache) with data[middle..one_after_last-1]
+//
+static inline void GT_NAME(bms_merge_external)(GT *data,GT_INDEX first,GT_INDEX middle,GT_INDEX one_after_last,GT *cache)
+{
+  GT_INDEX i,n_a,j,k;
+
+  n_a = middle - first;
+  memcpy(cache,&data[first],(size_t)n_a * sizeof(GT));
+  for(i = 0,j = middle,k = first;i < n_a && j < one_after_last;)
+    data[k++] = GT_LESS(data[j],cache[i]) ? data[j++] : cache[i++];
+  while(i < n_a)
+    data[k++] = cache[i++];
+}
+
+//
+// merge without extra memory: split the larger run in half, find where its middle item goes in the other run, rotate
+// the two parts that are in the wrong order, and merge the two halves recursively
+//
+static inline void GT_NAME(bms_merge_in_place)(GT *data,GT_INDEX first,GT_INDEX middle,GT_INDEX one_after_last)
+{
+  GT_INDEX cut_a,cut_b,new_middle;
+
+  while(first < middle && middle < one_after_last && GT_LESS(data[middle],data[middle - 1]))
+  { // (if the last item of A is not larger than the first item of B the two runs are already merged)
+    if(middle - first >= one_after_last - middle)
+    {
+      cut_a = first + (middle - first) / 2;
+      cut_b = GT_NAME(bms_binary_first)(data,middle,one_after_last,data[cut_a]);
+    }
+    else
+    {
+      cut_b = middle + (one_after_last - middle) / 2;
+      cut_a = GT_NAME(bms_binary_last)(data,first,middle,data[cut_b]);
+    }
+    GT_NAME(bms_rotate)(data,cut_a,middle,cut_b,NULL,0);
+    new_middle = cut_a + (cut_b - middle);
+    GT_NAME(bms_merge_in_place)(data,first,cut_a,new_middle);
+    first = new_middle; // second half (iteratively)
+    middle = cut_b;
+  }
+}
+
+//
+// stable merge of the sorted runs data[first..middle-1] (A) and data[middle..one_after_last-1] (B)
+//
+static inline void GT_NAME(bms_merge)(GT *data,GT_INDEX first,GT_INDEX middle,GT_INDEX one_after_last,GT *cache,GT_INDEX cache_size,GT_INDEX *tags)
+{
+  GT_INDEX i,j,block_size,n_tags,a_start,a_end,b_start,b_end,last_a_start,last_a_end,last_b_start,last_b_end,split,b_remaining;
+
+  if(first == middle || middle == one_after_last || !GT_LESS(data[middle],data[middle - 1]))
+    return; // nothing to do
+  if(GT_LESS(data[one_after_last - 1],data[first]))
+  { // all of B goes before A
+    GT_NAME(bms_rotate)(data,first,middle,one_after_last,cache,cache_size);
+    return;
+  }
+  if(middle - first <= cache_size)
+  {
+    GT_NAME(bms_merge_external)(data,first,middle,one_after_last,cache);
+    return;
+  }
+  //
+  // block merge (the A blocks have block_size items, except the first one; the last B block may also be smaller)
+  //
+  block_size = (GT_INDEX)sqrt((double)(middle - first));
+  if(block_size > cache_size)
+    block_size = cache_size;
+  last_a_start = first;                   // the irregular first A block is the first dropped A block
+  last_a_end = first + (middle - first) % block_size;
+  last_b_start = last_b_end = last_a_end; // the B items after the last dropped A block (none yet)
+  a_start = last_a_end;                   // the A blocks still to be dropped
+  a_end = middle;
+  b_start = middle;                       // the next B block
+  b_end = (one_after_last - middle > block_size) ? middle + block_size : one_after_last;
+  for(n_tags = 0;n_tags < (a_end - a_start) / block_size;n_tags++)
+    tags[n_tags] = n_tags;                // the original order of the A blocks, in the order they have in the array
+  for(;;)
+  {
+    for(i = 0,j = 1;j < n_tags;j++) // the smallest A block is data[a_start+i*block_size..]
+      if(tags[j] < tags[i])
+        i = j;
+    if(b_start == b_end || (last_b_end > last_b_start && !GT_LESS(data[last_b_end - 1],data[a_start + i * block_size])))
+    { // drop the smallest A block (some B items of the last B block, or all of them, must come after it)
+      split = GT_NAME(bms_binary_first)(data,last_b_start,last_b_end,data[a_start + i * block_size]);
+      b_remaining = last_b_end - split;
+      if(i != 0)
+      { // swap the smallest A block to the front of the A blocks
+        GT_NAME(bms_block_swap)(data,a_start,a_start + i * block_size,block_size);
+        j = tags[0];
+        tags[0] = tags[i];
+        tags[i] = j;
+      }
+      GT_NAME(bms_merge_external)(data,last_a_start,last_a_end,split,cache);         // previous A block, B items before split
+      GT_NAME(bms_rotate)(data,split,a_start,a_start + block_size,cache,cache_size); // drop the A block before the others
+      last_a_start = a_start - b_remaining;
+      last_a_end = last_a_start + block_size;
+      last_b_start = last_a_end;
+      last_b_end = last_b_start + b_remaining;
+      a_start += block_size;
+      for(j = 1;j < n_tags;j++)
+        tags[j - 1] = tags[j];
+      if(--n_tags == 0)
+        break;
+    }
+    else if(b_end - b_start < block_size)
+    { // move the last (smaller) B block before the A blocks
+      GT_NAME(bms_rotate)(data,a_start,b_start,b_end,cache,cache_size);
+      last_b_start = a_start;
+      last_b_end = a_start + (b_end - b_start);
+      a_start += b_end - b_start;
+      a_end += b_end - b_start;
+      b_start = b_end;
+    }
+    else
+    { // roll the leftmost A block to the end of the A blocks, by swapping it with the next B block
+      GT_NAME(bms_block_swap)(data,a_start,b_start,block_size);
+      last_b_start = a_start;
+      last_b_end = a_start + block_size;
+      a_start += block_size;
+      a_end += block_size;
+      b_start += block_size;
+      b_end = (one_after_last - b_end > block_size) ? b_end + block_size : one_after_last;
+      j = tags[0];
+      for(i = 1;i < n_tags;i++)
+        tags[i - 1] = tags[i];
+      tags[n_tags - 1] = j;
+    }
+  }
+  GT_NAME(bms_merge_external)(data,last_a_start,last_a_end,one_after_last,cache); // the last A block with the rest of B
+}
+
+static inline void GT_NAME(block_merge_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+# define RUN_SIZE  16
+  GT_INDEX i,w,n,cache_size,*tags;
+  GT *cache;
+
+  n = one_after_last - first;
+  if(n <= RUN_SIZE)
+  {
+    GT_NAME(insertion_sort)(data,first,one_after_last);
+    return;
+  }
+  cache_size = (GT_INDEX)sqrt((double)n) + 1;
+  cache = (GT *)malloc((size_t)cache_size * sizeof(GT));
+  tags = (GT_INDEX *)malloc((size_t)(cache_size + 4) * sizeof(GT_INDEX)); // there are at most sqrt(|A|)+3 A blocks
+  for(i = first;i < one_after_last;i += RUN_SIZE)
+    GT_NAME(insertion_sort)(data,i,(one_after_last - i > RUN_SIZE) ? i + RUN_SIZE : one_after_last);
+  for(w = RUN_SIZE;w < n;w *= 2)
+    for(i = first;one_after_last - i > w;i += 2 * w)
+      if(cache != NULL && tags != NULL)
+        GT_NAME(bms_merge)(data,i,i + w,(one_after_last - i - w > w) ? i + 2 * w : one_after_last,cache,cache_size,tags);
+      else
+        GT_NAME(bms_merge_in_place)(data,i,i + w,(one_after_last - i - w > w) ? i + 2 * w : one_after_last);
+  free(tags);
+  free(cache);
+# undef RUN_SIZE
+}
@@ -0,0 +1,135 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// quick sort with a branchless partition (BlockQuicksort, S. Edelkamp and A. Weiß, 2016)
+//
+// In the partition loop of quick_sort() the outcome of data[i] < pivot is (for random data) unpredictable, so about
+// half of the conditional branches are mispredicted. Here the partition scans a block of BLOCK_SIZE items at the left
+// end and another at the right end, and stores the offsets of the misplaced items in two small buffers; the comparison
+// result is only used to advance the buffer index (no branch). The misplaced items are then swapped in bulk. The last
+// (at most 2*BLOCK_SIZE) items are partitioned by a branchless version of Lomuto's partition.
+//
+// Duplicates: when two of the three items used to choose the pivot are equal (which is what happens most of the time
+// in ranges with many duplicates), the items not smaller than the pivot are partitioned a second time, into "equal to
+// the pivot" and "larger than the pivot", so that, as in quick_sort(), the "equal" part is done.
+//
+
+#include "sorting_methods.h"
+
+#define BLOCK_SIZE              128 // must not be larger than 256 (offsets are stored in unsigned chars)
+#define INSERTION_SORT_LIMIT     20
+
+#define SWAP(i,j)  do { T tmp_ = data[i]; data[i] = data[j]; data[j] = tmp_; } while(0)
+
+//
+// branchless partition of data[first..one_after_last-1]; the items for which LEFT(x) is true go to the left, and the
+// return value is the index of the first item of the right part
+//
+#define BLOCK_PARTITION(name,LEFT)                                                                                     \
+  static int name(T *data,int first,int one_after_last,T pivot)                                                        \
+  {                                                                                                                    \
+    unsigned char offsets_l[BLOCK_SIZE],offsets_r[BLOCK_SIZE];                                                         \
+    int l,r,j,k,n_l,n_r,start_l,start_r,n;                                                                             \
+    T tmp;                                                                                                             \
+                                                                                                                       \
+    l = first;          /* data[l..l+BLOCK_SIZE-1] is the current left block */                                        \
+    r = one_after_last; /* data[r-BLOCK_SIZE..r-1] is the current right block */                                       \
+    n_l = n_r = start_l = start_r = 0;                                                                                 \
+    while(r - l > 2 * BLOCK_SIZE)                                                                                      \
+    {                                                                                                                  \
+      if(n_l == 0)                                                                                                     \
+      { /* offsets of the items of the left block that belong to the right */                                         \
+        start_l = 0;                                                                                                   \
+        for(j = 0;j < BLOCK_SIZE;j++)                                                                                  \
+        {                                                                                                              \
+          offsets_l[n_l] = (unsigned char)j;                                                                           \
+          n_l += !(LEFT(data[l + j]));                                                                                 \
+        }                                                                                                              \
+      }                                                                                                                \
+      if(n_r == 0)                                                                                                     \
+      { /* offsets (from the end) of the items of the right block that belong to the left */                          \
+        start_r = 0;                                                                                                   \
+        for(j = 0;j < BLOCK_SIZE;j++)                                                                                  \
+        {                                                                                                              \
+          offsets_r[n_r] = (unsigned char)j;                                                                           \
+          n_r += (LEFT(data[r - 1 - j])) != 0;                                                                         \
+        }                                                                                                              \
+      }                                                                                                                \
+      n = (n_l < n_r) ? n_l : n_r;                                                                                     \
+      for(k = 0;k < n;k++)                                                                                             \
+      {                                                                                                                \
+        tmp = data[l + offsets_l[start_l + k]];                                                                        \
+        data[l + offsets_l[start_l + k]] = data[r - 1 - offsets_r[start_r + k]];                                       \
+        data[r - 1 - offsets_r[start_r + k]] = tmp;                                                                    \
+      }                                                                                                                \
+      n_l -= n;                                                                                                        \
+      n_r -= n;                                                                                                        \
+      start_l += n;                                                                                                    \
+      start_r += n;                                                                                                    \
+      if(n_l == 0)                                                                                                     \
+        l += BLOCK_SIZE; /* left block done */                                                                         \
+      if(n_r == 0)                                                                                                     \
+        r -= BLOCK_SIZE; /* right block done */                                                                        \
+    }                                                                                                                  \
+    /* branchless Lomuto partition of data[l..r-1]: data[l..k-1] left items, data[k..j-1] right items */               \
+    for(j = k = l;j < r;j++)                                                                                           \
+    {                                                                                                                  \
+      tmp = data[j];                                                                                                   \
+      data[j] = data[k];                                                                                               \
+      data[k] = tmp;                                                                                                   \
+      k += (LEFT(tmp)) != 0;                                                                                           \
+    }                                                                                                                  \
+    return k;                                                                                                          \
+  }
+
+#define LESS(x)        ((x) < pivot)
+#define LESS_EQUAL(x)  (!(pivot < (x)))
+BLOCK_PARTITION(block_partition_less,LESS)
+BLOCK_PARTITION(block_partition_less_equal,LESS_EQUAL)
+#undef LESS
+#undef LESS_EQUAL
+
+void block_quick_sort(T *data,int first,int one_after_last)
+{
+  int middle,first_equal,one_after_equal,duplicates;
+  T pivot;
+
+  while(one_after_last - first >= INSERTION_SORT_LIMIT)
+  {
+    //
+    // median of three (the pivot goes to data[first])
+    //
+    middle = first + (one_after_last - first) / 2;
+    if(data[middle] < data[first])
+      SWAP(first,middle);
+    if(data[one_after_last - 1] < data[middle])
+      SWAP(middle,one_after_last - 1);
+    if(data[middle] < data[first])
+      SWAP(first,middle);
+    duplicates = !(data[first] < data[middle]) || !(data[middle] < data[one_after_last - 1]);
+    SWAP(first,middle);
+    pivot = data[first];
+    //
+    // partition: |first "smaller"|first_equal "equal"|one_after_equal "larger"|one_after_last
+    //
+    first_equal = block_partition_less(data,first + 1,one_after_last,pivot) - 1;
+    SWAP(first,first_equal);
+    one_after_equal = first_equal + 1;
+    if(duplicates != 0)
+      one_after_equal = block_partition_less_equal(data,one_after_equal,one_after_last,pivot);
+    //
+    // recurse on the smaller side, iterate on the larger one
+    //
+    if(first_equal - first < one_after_last - one_after_equal)
+    {
+      block_quick_sort(data,first,first_equal);
+      first = one_after_equal;
+    }
+    else
+    {
+      block_quick_sort(data,one_after_equal,one_after_last);
+      one_after_last = first_equal;
+    }
+  }
+  insertion_sort(data,first,one_after_last);
+}
@@ -0,0 +1,142 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// counting sort and bucket sort, for keys in a bounded range
+//
+// Both routines first find the smallest and the largest key, so the range k = max - min + 1 of the keys does not have
+// to be given.
+//
+// counting_sort() counts how many times each key of the range occurs, and then writes the keys back in order, in
+// O(n+k) time and with O(k) extra memory. It is used when k is at most COUNTING_SORT_MAX_RANGE and not much larger
+// than n; otherwise the keys are sorted by intro_sort().
+//
+// bucket_sort() handles wider ranges: the range is split into a power of two number of buckets of equal width (about
+// BUCKET_SIZE items per bucket if the keys are uniformly spread), the items are distributed into the buckets (a
+// counting pass and a scattering pass, with O(n) extra memory), and each bucket is sorted on its own, by insertion
+// sort if it is small, and by intro_sort() if it is not. If the keys are spread uniformly over their range this takes
+// O(n) time on average; if they are not, the large buckets are sorted by comparisons, so the time is at most
+// O(n log n). Ranges for which counting_sort() is usable are handed over to it.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "sorting_methods.h"
+
+#define INSERTION_SORT_LIMIT          32  // ranges (and buckets) smaller than this are sorted by insertion sort
+#define COUNTING_SORT_MAX_RANGE  4194304  // largest key range for counting sort (16 MiB of counters)
+#define BUCKET_SIZE                    4  // desired average number of items per bucket
+
+//
+// smallest and largest keys; the return value is the size of the range (it may not fit in an int)
+//
+static int64_t key_range(T *data,int first,int one_after_last,T *min_p,T *max_p)
+{
+  T min,max;
+  int i;
+
+  min = max = data[first];
+  for(i = first + 1;i < one_after_last;i++)
+    if(data[i] < min)
+      min = data[i];
+    else if(data[i] > max)
+      max = data[i];
+  *min_p = min;
+  *max_p = max;
+  return (int64_t)max - (int64_t)min + 1;
+}
+
+static int counting_sort_usable(int64_t k,int n)
+{
+  return k <= (int64_t)COUNTING_SORT_MAX_RANGE && k <= 4 * (int64_t)n + 1024;
+}
+
+//
+// counting sort of a range of keys known to be in [min,min+k-1]; returns 0 if there is not enough memory
+//
+static int counting_sort_range(T *data,int first,int one_after_last,T min,int k)
+{
+  int i,j,*count;
+
+  count = (int *)calloc((size_t)k,sizeof(int));
+  if(count == NULL)
+    return 0;
+  for(i = first;i < one_after_last;i++)
+    count[data[i] - min]++;
+  for(i = 0,j = first;i < k;i++)
+    while(count[i]-- > 0)
+      data[j++] = min + i;
+  free(count);
+  return 1;
+}
+
+void counting_sort(T *data,int first,int one_after_last)
+{
+  int64_t k;
+  T min,max;
+
+  if(one_after_last - first < INSERTION_SORT_LIMIT)
+  {
+    insertion_sort(data,first,one_after_last);
+    return;
+  }
+  k = key_range(data,first,one_after_last,&min,&max);
+  if(counting_sort_usable(k,one_after_last - first) == 0 || counting_sort_range(data,first,one_after_last,min,(int)k) == 0)
+    intro_sort(data,first,one_after_last); // range too wide (or not enough memory)
+}
+
+void bucket_sort(T *data,int first,int one_after_last)
+{
+  int i,n,n_buckets,shift,bucket,start,*count;
+  int64_t k;
+  T min,max,*buffer;
+
+  n = one_after_last - first;
+  if(n < INSERTION_SORT_LIMIT)
+  {
+    insertion_sort(data,first,one_after_last);
+    return;
+  }
+  k = key_range(data,first,one_after_last,&min,&max);
+  if(counting_sort_usable(k,n) != 0 && counting_sort_range(data,first,one_after_last,min,(int)k) != 0)
+    return;
+  //
+  // n_buckets is the smallest power of two not smaller than n/BUCKET_SIZE, and the bucket of the item x is
+  // (x-min)>>shift, with shift as small as possible
+  //
+  for(n_buckets = 1;n_buckets < n / BUCKET_SIZE;n_buckets <<= 1)
+    ;
+  for(shift = 0;((uint64_t)(k - 1) >> shift) >= (uint64_t)n_buckets;shift++)
+    ;
+  count = (int *)calloc((size_t)n_buckets + 1,sizeof(int));
+  buffer = (T *)malloc((size_t)n * sizeof(T));
+  if(count == NULL || buffer == NULL)
+  { // not enough memory
+    free(count);
+    free(buffer);
+    intro_sort(data,first,one_after_last);
+    return;
+  }
+# define BUCKET(x)  (int)(((uint32_t)(x) - (uint32_t)min) >> shift)
+  //
+  // count[b+1] becomes the number of items of the bucket b, and then the index of the first item of the bucket b+1
+  //
+  for(i = first;i < one_after_last;i++)
+    count[BUCKET(data[i]) + 1]++;
+  for(bucket = 1;bucket < n_buckets;bucket++)
+    count[bucket + 1] += count[bucket];
+  for(i = first;i < one_after_last;i++)
+    buffer[count[BUCKET(data[i])]++] = data[i];
+# undef BUCKET
+  //
+  // now count[b] is the index of the first item of the bucket b+1; sort each bucket
+  //
+  for(bucket = start = 0;bucket < n_buckets;start = count[bucket++])
+    if(count[bucket] - start < INSERTION_SORT_LIMIT)
+      insertion_sort(buffer,start,count[bucket]);
+    else
+      intro_sort(buffer,start,count[bucket]);
+  memcpy(data + first,buffer,(size_t)n * sizeof(T));
+  free(buffer);
+  free(count);
+}
@@ -0,0 +1,135 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// dual-pivot quick sort (V. Yaroslavskiy, 2009, as in the Arrays.sort() of Java 7)
+//
+// Two pivots p1 <= p2, the second and fourth items of a sorted sample of five items spread over the range, split the
+// range in a single pass into three parts, "smaller than p1", "between p1 and p2", and "larger than p2". The number
+// of comparisons is about the same as that of quick_sort(), but there are fewer swaps and, above all, fewer passes
+// over the data (each pass makes three parts instead of two, so there are about log3(n) levels of recursion instead
+// of log2(n)), and that is what counts when the data does not fit in the caches.
+//
+// Duplicates:
+//   * if the two pivots are equal (which is what happens most of the time in ranges with many duplicates), the range
+//     is partitioned in the same way as in quick_sort() (three_way_partition()), so the "equal" part is done
+//   * if the middle part is large (more than 4/7 of the range, which suggests that p1 or p2 occur many times), the
+//     items equal to p1 and the items equal to p2 are moved to its ends, and only the rest is sorted
+//
+
+#include "sorting_methods.h"
+
+#define INSERTION_SORT_LIMIT  27
+
+#define SWAP(i,j)  do { T tmp_ = data[i]; data[i] = data[j]; data[j] = tmp_; } while(0)
+#define SORT2(i,j) do if(data[j] < data[i]) SWAP(i,j); while(0)
+
+void dual_pivot_quick_sort(T *data,int first,int one_after_last)
+{
+  int n,seventh,e1,e2,e3,e4,e5,less,great,k,first_equal,one_after_equal;
+  T p1,p2,x;
+
+  n = one_after_last - first;
+  if(n < INSERTION_SORT_LIMIT)
+  {
+    insertion_sort(data,first,one_after_last);
+    return;
+  }
+  //
+  // sort the sample of five items (a sorting network with 9 comparators)
+  //
+  seventh = (n >> 3) + (n >> 6) + 1; // about n/7
+  e3 = first + (n >> 1);
+  e2 = e3 - seventh;
+  e1 = e2 - seventh;
+  e4 = e3 + seventh;
+  e5 = e4 + seventh;
+  SORT2(e1,e2); SORT2(e4,e5); SORT2(e3,e5);
+  SORT2(e3,e4); SORT2(e1,e4); SORT2(e1,e3);
+  SORT2(e2,e5); SORT2(e2,e4); SORT2(e2,e3);
+  if(data[e2] == data[e4])
+  { // one pivot, and a 3-way partition
+    SWAP(e3,one_after_last - 1);
+    three_way_partition(data,first,one_after_last,&first_equal,&one_after_equal);
+    dual_pivot_quick_sort(data,first,first_equal);
+    dual_pivot_quick_sort(data,one_after_equal,one_after_last);
+    return;
+  }
+  //
+  // partition; during the loop the items are as follows:
+  // |first p1|first+1  "< p1"|less  ">= p1 and <= p2"|k  "not seen yet"|great+1  "> p2"|one_after_last-1 p2|
+  //
+  p1 = data[e2];
+  p2 = data[e4];
+  data[e2] = data[first];
+  data[e4] = data[one_after_last - 1];
+  less = first + 1;
+  great = one_after_last - 2;
+  while(data[less] < p1)
+    less++;
+  while(data[great] > p2)
+    great--;
+  for(k = less;k <= great;k++)
+  {
+    x = data[k];
+    if(x < p1)
+    {
+      data[k] = data[less];
+      data[less++] = x;
+    }
+    else if(x > p2)
+    {
+      while(data[great] > p2 && k < great)
+        great--;
+      data[k] = data[great];
+      data[great--] = x;
+      x = data[k];
+      if(x < p1)
+      {
+        data[k] = data[less];
+        data[less++] = x;
+      }
+    }
+  }
+  //
+  // place the pivots, and sort the "smaller" and "larger" parts
+  //
+  data[first] = data[less - 1];
+  data[less - 1] = p1;
+  data[one_after_last - 1] = data[great + 1];
+  data[great + 1] = p2;
+  dual_pivot_quick_sort(data,first,less - 1);
+  dual_pivot_quick_sort(data,great + 2,one_after_last);
+  //
+  // the middle part, data[less..great]
+  //
+  if(great - less + 1 > n / 7 * 4)
+  { // move the items equal to p1 to the left end, and the items equal to p2 to the right end (they are done)
+    while(less <= great && data[less] == p1)
+      less++;
+    while(less <= great && data[great] == p2)
+      great--;
+    for(k = less;k <= great;k++)
+    {
+      x = data[k];
+      if(x == p1)
+      {
+        data[k] = data[less];
+        data[less++] = x;
+      }
+      else if(x == p2)
+      {
+        while(data[great] == p2 && k < great)
+          great--;
+        data[k] = data[great];
+        data[great--] = x;
+        x = data[k];
+        if(x == p1)
+        {
+          data[k] = data[less];
+          data[less++] = x;
+        }
+      }
+    }
+  }
+  dual_pivot_quick_sort(data,less,great + 1);
+}
@@ -0,0 +1,422 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// external (out of core) sort of a binary file of T items (native byte order), for files larger than the memory
+//
+// Phase 1: the input file is mapped into memory (mmap, private, so that the file itself is not modified), one chunk at
+//          a time. Each chunk is sorted by parallel_sample_sort() (with sort_threads() threads; with only one thread
+//          radix_sort() is used), the fastest sorts of random ints, and written to a runs file
+//          (output_file_name.runs). If there is only one chunk it is written directly to the output file. Both sorts
+//          need a buffer as large as the chunk (and parallel_sample_sort() also needs 2 bytes per item for its
+//          "oracle"), so a chunk is only a bit less than half of memory_size bytes.
+// Phase 2: the runs are merged by a k-way merge driven by a loser tree (after an item is output, only the path from its
+//          leaf to the root is replayed, with one comparison per level). Each run has two input buffers: while the
+//          merge consumes one of them the other one is being filled by an asynchronous read (POSIX aio); likewise, one
+//          output buffer is filled while the other one is being written. The memory is divided evenly between the
+//          2*(k+1) buffers (but each one has at least MIN_BLOCK_SIZE bytes).
+//
+// The throughput (file size divided by the wall-clock time) of each phase is reported in MB/s (1 MB = 10^6 bytes).
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include "sorting_methods.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <aio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MIN_BLOCK_SIZE  (1 << 16) // smallest I/O buffer of the merge phase, in bytes
+
+typedef struct
+{
+  off_t next_offset;   // file offset of the next block to read
+  size_t n_unread;     // number of items not yet read
+  T *buffer[2];        // the two buffers
+  int current;         // the buffer being consumed
+  size_t position;     // index of the current item in the current buffer
+  size_t length;       // number of items in the current buffer
+  int pending;         // 1 if a read into the other buffer is in progress
+  struct aiocb cb;     // the read
+}
+ext_run_t;
+
+static double now(void)
+{
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return (double)t.tv_sec + 1.0e-9 * (double)t.tv_nsec;
+}
+
+static int write_all(int fd,void *data,size_t n_bytes,off_t offset)
+{
+  ssize_t r;
+
+  while(n_bytes > 0)
+  {
+    if((r = pwrite(fd,data,n_bytes,offset)) <= 0)
+      return -1;
+    data = (char *)data + r;
+    n_bytes -= (size_t)r;
+    offset += (off_t)r;
+  }
+  return 0;
+}
+
+static int same_file(char *file_name,struct stat *st)
+{ // 1 if file_name exists and is the file described by st (another name, or a link, for it)
+  struct stat other;
+
+  return stat(file_name,&other) == 0 && other.st_dev == st->st_dev && other.st_ino == st->st_ino;
+}
+
+static ssize_t wait_aio(struct aiocb *cb)
+{ // wait for an asynchronous read or write, and return its result
+  const struct aiocb *list[1];
+
+  list[0] = cb;
+  while(aio_error(cb) == EINPROGRESS)
+    aio_suspend(list,1,NULL);
+  return aio_return(cb);
+}
+
+
+//
+// input runs (double buffered)
+//
+
+static int start_read(ext_run_t *run,int fd,size_t block_items)
+{ // start reading the next block of the run into the buffer that is not being consumed
+  size_t n;
+
+  if(run->n_unread == 0)
+    return 0;
+  n = (run->n_unread < block_items) ? run->n_unread : block_items;
+  memset(&run->cb,0,sizeof(run->cb));
+  run->cb.aio_fildes = fd;
+  run->cb.aio_buf = run->buffer[1 - run->current];
+  run->cb.aio_nbytes = n * sizeof(T);
+  run->cb.aio_offset = run->next_offset;
+  if(aio_read(&run->cb) != 0)
+    return -1;
+  run->pending = 1;
+  run->next_offset += (off_t)(n * sizeof(T));
+  run->n_unread -= n;
+  return 0;
+}
+
+static int next_buffer(ext_run_t *run,int fd,size_t block_items)
+{ // switch buffers (1 if there is more data, 0 if the run is exhausted, -1 on error)
+  ssize_t r;
+
+  if(run->pending == 0)
+    return 0;
+  r = wait_aio(&run->cb);
+  run->pending = 0;
+  if(r <= 0 || (size_t)r != run->cb.aio_nbytes)
+    return -1; // (a short read of a regular file only happens on errors)
+  run->current = 1 - run->current;
+  run->position = 0;
+  run->length = (size_t)r / sizeof(T);
+  return (start_read(run,fd,block_items) < 0) ? -1 : 1;
+}
+
+
+//
+// loser tree (tree[1..k-1] are the losers of the matches, tree[0] is the overall winner; the leaves, which are not
+// stored, are the nodes k..2k-1); an exhausted run loses against all others, and equal items are taken from the
+// run with the smaller index (the merge is stable)
+//
+
+static int beats(ext_run_t *runs,int *done,int a,int b)
+{
+  T x,y;
+
+  if(done[a] != 0)
+    return 0;
+  if(done[b] != 0)
+    return 1;
+  x = runs[a].buffer[runs[a].current][runs[a].position];
+  y = runs[b].buffer[runs[b].current][runs[b].position];
+  return (x < y) || (!(y < x) && a < b);
+}
+
+static int build_tree(ext_run_t *runs,int *done,int *tree,int k,int node)
+{ // play the matches of the subtree rooted at node, and return its winner
+  int a,b;
+
+  if(node >= k)
+    return node - k;
+  a = build_tree(runs,done,tree,k,2 * node);
+  b = build_tree(runs,done,tree,k,2 * node + 1);
+  if(beats(runs,done,a,b) != 0)
+  {
+    tree[node] = b;
+    return a;
+  }
+  tree[node] = a;
+  return b;
+}
+
+static void replay(ext_run_t *runs,int *done,int *tree,int k,int w)
+{ // the run w (the last winner) has a new current item
+  int node,tmp;
+
+  for(node = (w + k) / 2;node >= 1;node /= 2)
+    if(beats(runs,done,tree[node],w) != 0)
+    {
+      tmp = tree[node];
+      tree[node] = w;
+      w = tmp;
+    }
+  tree[0] = w;
+}
+
+
+//
+// the external sort
+//
+
+static int merge_runs(int runs_fd,int out_fd,size_t n_items,size_t chunk_items,int k,size_t memory_size)
+{
+  ext_run_t *runs;
+  struct aiocb out_cb;
+  T *out_buffer[2];
+  size_t block_items,i,out_position,n_written;
+  int r,w,out_current,out_pending,*done,*tree,error;
+
+  block_items = memory_size / (2 * ((size_t)k + 1) * sizeof(T));
+  if(block_items * sizeof(T) < MIN_BLOCK_SIZE)
+    block_items = MIN_BLOCK_SIZE / sizeof(T);
+  runs = (ext_run_t *)calloc((size_t)k,sizeof(ext_run_t));
+  done = (int *)calloc((size_t)k,sizeof(int));
+  tree = (int *)calloc((size_t)k + 1,sizeof(int));
+  out_buffer[0] = (T *)malloc(2 * block_items * sizeof(T));
+  out_pending = 0;
+  n_written = 0;
+  error = 1;
+  if(runs == NULL || done == NULL || tree == NULL || out_buffer[0] == NULL)
+    goto cleanup;
+  out_buffer[1] = out_buffer[0] + block_items;
+  for(w = 0;w < k;w++)
+  {
+    runs[w].next_offset = (off_t)((size_t)w * chunk_items * sizeof(T));
+    runs[w].n_unread = (n_items - (size_t)w * chunk_items < chunk_items) ? n_items - (size_t)w * chunk_items : chunk_items;
+    runs[w].buffer[0] = (T *)malloc(2 * block_items * sizeof(T));
+    if(runs[w].buffer[0] == NULL)
+      goto cleanup;
+    runs[w].buffer[1] = runs[w].buffer[0] + block_items;
+    runs[w].current = 1; // the first read goes to buffer[0]
+    if(start_read(&runs[w],runs_fd,block_items) < 0 || next_buffer(&runs[w],runs_fd,block_items) != 1)
+      goto cleanup;
+  }
+  error = 0;
+  tree[0] = (k > 1) ? build_tree(runs,done,tree,k,1) : 0;
+  out_current = 0;
+  out_position = 0;
+  memset(&out_cb,0,sizeof(out_cb));
+  while(error == 0 && done[w = tree[0]] == 0)
+  {
+    out_buffer[out_current][out_position++] = runs[w].buffer[runs[w].current][runs[w].position++];
+    if(runs[w].position == runs[w].length && (r = next_buffer(&runs[w],runs_fd,block_items)) != 1)
+    {
+      done[w] = 1;
+      error = (r < 0);
+    }
+    replay(runs,done,tree,k,w);
+    if(out_position == block_items || done[tree[0]] != 0)
+    { // write the output buffer (after the previous write has finished)
+      if(out_pending != 0 && (size_t)wait_aio(&out_cb) != out_cb.aio_nbytes)
+        error = 1;
+      out_pending = 0;
+      memset(&out_cb,0,sizeof(out_cb));
+      out_cb.aio_fildes = out_fd;
+      out_cb.aio_buf = out_buffer[out_current];
+      out_cb.aio_nbytes = out_position * sizeof(T);
+      out_cb.aio_offset = (off_t)(n_written * sizeof(T));
+      if(aio_write(&out_cb) != 0)
+        error = 1;
+      else
+        out_pending = 1;
+      n_written += out_position;
+      out_current = 1 - out_current;
+      out_position = 0;
+    }
+  }
+cleanup: // on errors, cancel the reads and the write that are still in progress (their buffers are about to be freed)
+  if(out_pending != 0)
+  {
+    if(error != 0)
+      (void)aio_cancel(out_fd,&out_cb);
+    if((size_t)wait_aio(&out_cb) != out_cb.aio_nbytes)
+      error = 1;
+  }
+  for(i = 0;runs != NULL && i < (size_t)k;i++)
+  {
+    if(runs[i].pending != 0)
+    {
+      if(error != 0)
+        (void)aio_cancel(runs_fd,&runs[i].cb);
+      (void)wait_aio(&runs[i].cb);
+    }
+    free(runs[i].buffer[0]);
+  }
+  free(out_buffer[0]);
+  free(tree);
+  free(done);
+  free(runs);
+  return (error != 0 || n_written != n_items) ? -1 : 0;
+}
+
+int external_sort(char *input_file_name,char *output_file_name,size_t memory_size)
+{
+  char runs_file_name[PATH_MAX];
+  size_t n_items,chunk_items,page_items,first,n;
+  struct stat st;
+  double t0,t1,t2,mb;
+  int in_fd,out_fd,runs_fd,k,r,status;
+  T *chunk;
+
+  //
+  // open the files (all errors go to the cleanup at the end, which closes the files and removes the runs file)
+  //
+  in_fd = out_fd = runs_fd = -1;
+  status = 1;
+  if((in_fd = open(input_file_name,O_RDONLY)) < 0 || fstat(in_fd,&st) != 0)
+  {
+    fprintf(stderr,"external_sort: unable to open %s --- 😒\n",input_file_name);
+    goto cleanup;
+  }
+  if(st.st_size % (off_t)sizeof(T) != 0)
+  {
+    fprintf(stderr,"external_sort: the size of %s is not a multiple of %d --- 😒\n",input_file_name,(int)sizeof(T));
+    goto cleanup;
+  }
+  n_items = (size_t)st.st_size / sizeof(T);
+  if(same_file(output_file_name,&st) != 0)
+  { // O_TRUNC would destroy the input (and its mapped chunks)
+    fprintf(stderr,"external_sort: %s and %s are the same file --- 😒\n",input_file_name,output_file_name);
+    goto cleanup;
+  }
+  if((out_fd = open(output_file_name,O_RDWR | O_CREAT | O_TRUNC,0644)) < 0)
+  {
+    fprintf(stderr,"external_sort: unable to create %s --- 😒\n",output_file_name);
+    goto cleanup;
+  }
+  //
+  // chunk size: the chunk and the memory of the sort of phase 1 fit in memory_size bytes; a multiple of the page size
+  // (mmap offsets must be page aligned), at most INT_MAX items
+  //
+  page_items = (size_t)sysconf(_SC_PAGESIZE) / sizeof(T);
+  chunk_items = memory_size / (2 * sizeof(T) + ((sort_threads() > 1) ? sizeof(unsigned short) : 0));
+  if(chunk_items > (size_t)INT_MAX)
+    chunk_items = (size_t)INT_MAX;
+  chunk_items -= chunk_items % page_items;
+  if(chunk_items == 0)
+    chunk_items = page_items;
+  k = (int)((n_items + chunk_items - 1) / chunk_items);
+  if(k > 1)
+  {
+    snprintf(runs_file_name,sizeof(runs_file_name),"%s.runs",output_file_name);
+    if(same_file(runs_file_name,&st) != 0)
+    {
+      fprintf(stderr,"external_sort: %s and %s are the same file --- 😒\n",input_file_name,runs_file_name);
+      goto cleanup;
+    }
+    if((runs_fd = open(runs_file_name,O_RDWR | O_CREAT | O_TRUNC,0600)) < 0)
+    {
+      fprintf(stderr,"external_sort: unable to create %s --- 😒\n",runs_file_name);
+      goto cleanup;
+    }
+  }
+  else
+    runs_fd = out_fd;
+  //
+  // phase 1: sorted runs
+  //
+  t0 = now();
+  for(first = 0;first < n_items;first += n)
+  {
+    n = (n_items - first < chunk_items) ? n_items - first : chunk_items;
+#ifdef MAP_POPULATE
+    chunk = (T *)mmap(NULL,n * sizeof(T),PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_POPULATE,in_fd,(off_t)(first * sizeof(T)));
+#else
+    chunk = (T *)mmap(NULL,n * sizeof(T),PROT_READ | PROT_WRITE,MAP_PRIVATE,in_fd,(off_t)(first * sizeof(T)));
+#endif
+    if(chunk == (T *)MAP_FAILED)
+    {
+      fprintf(stderr,"external_sort: unable to map %s --- 😒\n",input_file_name);
+      goto cleanup;
+    }
+    if(sort_threads() > 1)
+      parallel_sample_sort(chunk,0,(int)n);
+    else
+      radix_sort(chunk,0,(int)n);
+    r = write_all(runs_fd,chunk,n * sizeof(T),(off_t)(first * sizeof(T)));
+    munmap(chunk,n * sizeof(T));
+    if(r != 0)
+    {
+      fprintf(stderr,"external_sort: unable to write the sorted runs --- 😒\n");
+      goto cleanup;
+    }
+  }
+  t1 = now();
+  //
+  // phase 2: merge
+  //
+  if(k > 1)
+  {
+    if(merge_runs(runs_fd,out_fd,n_items,chunk_items,k,memory_size) != 0)
+    {
+      fprintf(stderr,"external_sort: unable to merge the sorted runs (out of memory or input/output error) --- 😒\n");
+      goto cleanup;
+    }
+  }
+  t2 = now();
+  status = 0;
+cleanup:
+  if(runs_fd >= 0 && runs_fd != out_fd)
+  {
+    close(runs_fd);
+    unlink(runs_file_name);
+  }
+  if(out_fd >= 0)
+    close(out_fd);
+  if(in_fd >= 0)
+    close(in_fd);
+  if(status != 0)
+    return status;
+  //
+  // report
+  //
+  mb = (double)st.st_size * 1.0e-6;
+  printf("# external sort of %s (%.1f MB, %zu items) into %s\n",input_file_name,mb,n_items,output_file_name);
+  printf("# %d run%s of at most %zu items, %d thread%s\n",k,(k == 1) ? "" : "s",chunk_items,sort_threads(),(sort_threads() == 1) ? "" : "s");
+  printf("phase 1 (sort the runs) %8.3f s %9.1f MB/s\n",t1 - t0,mb / (t1 - t0));
+  if(k > 1)
+    printf("phase 2 (merge)         %8.3f s %9.1f MB/s\n",t2 - t1,mb / (t2 - t1));
+  printf("total                   %8.3f s %9.1f MB/s\n",t2 - t0,mb / (t2 - t0));
+  return 0;
+}
+
+#else
+
+int external_sort(char *input_file_name,char *output_file_name,size_t memory_size)
+{
+  (void)input_file_name;
+  (void)output_file_name;
+  (void)memory_size;
+  fprintf(stderr,"external_sort: not available on this system --- 😒\n");
+  return 1;
+}
+
+#endif
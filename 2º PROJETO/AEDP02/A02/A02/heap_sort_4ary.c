@@ -0,0 +1,100 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// cache-friendly heap sort (4-ary heap, bottom-up sift, prefetching)
+//
+// Differences to heap_sort():
+//   * the heap is 4-ary and 0-based (the children of node v are the nodes 4v+1..4v+4), so it has half as many levels
+//   * the array is aligned (see below) so that the four children of a node share a cache line, and so that the 16
+//     grandchildren of a node fill exactly one cache line; that line is prefetched while the children are compared
+//   * the sift-down is Floyd's bottom-up sift: the hole goes all the way down (always to the largest child, without
+//     comparing it with the item being sifted), and then the item climbs up from the leaf; most items belong near the
+//     leaves, so this saves almost all the comparisons with the item being sifted
+//
+// Alignment: the heap starts k items (0 <= k < 16) after data[first], chosen so that node 5 is at the start of a
+// 64-byte cache line. The first k items are sorted by insertion sort and then merged (using a small local array) with
+// the sorted heap part, so the extra memory is still O(1).
+//
+
+#include <stdint.h>
+#include "sorting_methods.h"
+
+#define CACHE_LINE_SIZE  64
+#define MAX_SKIP         (CACHE_LINE_SIZE / (int)sizeof(T))
+
+//
+// b[v] is a hole; place x in the sub-heap (of the heap b[0..n-1]) rooted at v
+//
+static inline void sift_down(T *b,int n,int v,T x)
+{
+  int top,c,m1,m2;
+
+  top = v;
+  while((c = 4 * v + 1) + 3 < n)
+  { // four children; go down to the largest one
+    if(16 * v + 5 < n)
+      __builtin_prefetch(&b[16 * v + 5]); // grandchildren
+    m1 = (b[c] < b[c + 1]) ? c + 1 : c;
+    m2 = (b[c + 2] < b[c + 3]) ? c + 3 : c + 2;
+    m1 = (b[m1] < b[m2]) ? m2 : m1;
+    b[v] = b[m1];
+    v = m1;
+  }
+  if(c < n)
+  { // one to three children (the last group)
+    for(m1 = c++;c < n;c++)
+      if(b[m1] < b[c])
+        m1 = c;
+    b[v] = b[m1];
+    v = m1;
+  }
+  while(v > top && b[c = (v - 1) / 4] < x)
+  { // climb up
+    b[v] = b[c];
+    v = c;
+  }
+  b[v] = x;
+}
+
+void heap_sort_4ary(T *data,int first,int one_after_last)
+{
+  int i,j,k,n;
+  T *b,tmp,head[MAX_SKIP];
+
+  if(one_after_last - first <= 2 * MAX_SKIP)
+  {
+    insertion_sort(data,first,one_after_last);
+    return;
+  }
+  //
+  // skip k items so that b[5] is at the start of a cache line
+  //
+  k = (int)(((uintptr_t)CACHE_LINE_SIZE - ((uintptr_t)&data[first + 5] % (uintptr_t)CACHE_LINE_SIZE)) % (uintptr_t)CACHE_LINE_SIZE / sizeof(T));
+  b = &data[first + k];
+  n = one_after_last - first - k;
+  //
+  // phase 1. heap construction
+  //
+  for(i = (n - 2) / 4;i >= 0;i--)
+    sift_down(b,n,i,b[i]);
+  //
+  // phase 2. sort
+  //
+  for(i = n - 1;i > 0;i--)
+  {
+    tmp = b[i];
+    b[i] = b[0]; // largest
+    sift_down(b,i,0,tmp);
+  }
+  //
+  // phase 3. merge the k skipped items (data[first..first+k-1]) with the heap part
+  //
+  if(k > 0)
+  {
+    insertion_sort(data,first,first + k);
+    for(i = 0;i < k;i++)
+      head[i] = data[first + i];
+    for(i = 0,j = first + k,n = first;i < k;n++) // the output position (n) never gets ahead of j
+      data[n] = (j < one_after_last && data[j] < head[i]) ? data[j++] : head[i++];
+  }
+}
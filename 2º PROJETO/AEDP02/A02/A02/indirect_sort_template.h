@@ -0,0 +1,73 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// type-generic indirect sort, for large records
+//
+// Like radix_sort_template.h, this file is a "template"; it has to be included after sorting_methods_template.h, with
+// the same GT and GT_SUFFIX, after the record16_t (r16) instance of the sorting routines, and it also needs
+//
+//   GT_INDIRECT_KEY(a)  the key of the item a, as an int64_t (the items are ordered by it)
+//
+// A direct sort of large records spends most of its time moving them (quick_sort, heap_sort, and Shell_sort move
+// each record many times). An indirect sort
+//   1. extracts (key,index) pairs into a compact record16_t array (16 bytes per record),
+//   2. sorts the pairs with one of the record16_t sorting routines, and
+//   3. moves each record to its final place, following the cycles of the permutation (each record is moved once,
+//      plus one extra move per cycle, through a temporary record).
+// GT_NAME(indirect_sort) receives the record16_t sorting routine as an argument; GT_NAME(indirect_quick_sort), and
+// so on, have the usual arguments. The number of records must be smaller than 2^31.
+//
+
+#include <stdlib.h>
+
+static inline void GT_NAME(indirect_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last,void (*sort)(record16_t *pairs,int first,int one_after_last))
+{
+  GT_INDEX i,j,k,n;
+  record16_t *pairs;
+  GT tmp;
+
+  n = one_after_last - first;
+  if(n < 2)
+    return;
+  pairs = (record16_t *)malloc((size_t)n * sizeof(record16_t));
+  if(pairs == NULL)
+  { // not enough memory for the pairs, sort directly
+    GT_NAME(heap_sort)(data,first,one_after_last);
+    return;
+  }
+  data += first;
+  for(i = 0;i < n;i++)
+  {
+    pairs[i].key = GT_INDIRECT_KEY(data[i]);
+    pairs[i].payload = (int64_t)i;
+  }
+  (*sort)(pairs,0,(int)n);
+  //
+  // data[i] must receive data[pairs[i].payload]; a pair whose payload is equal to its index is done
+  //
+  for(i = 0;i < n;i++)
+    if((GT_INDEX)pairs[i].payload != i)
+    {
+      tmp = data[i];
+      for(j = i;(k = (GT_INDEX)pairs[j].payload) != i;j = k)
+      {
+        data[j] = data[k];
+        pairs[j].payload = (int64_t)j;
+      }
+      data[j] = tmp;
+      pairs[j].payload = (int64_t)j;
+    }
+  free(pairs);
+}
+
+#define GT_INDIRECT(name)                                                                         \
+  static inline void GT_NAME(indirect_ ## name)(GT *data,GT_INDEX first,GT_INDEX one_after_last)  \
+  {                                                                                               \
+    GT_NAME(indirect_sort)(data,first,one_after_last,name ## _r16);                               \
+  }
+GT_INDIRECT(Shell_sort)
+GT_INDIRECT(quick_sort)
+GT_INDIRECT(merge_sort)
+GT_INDIRECT(heap_sort)
+GT_INDIRECT(radix_sort)
+#undef GT_INDIRECT
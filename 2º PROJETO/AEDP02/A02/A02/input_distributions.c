@@ -0,0 +1,155 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// input data distributions for the tests and measurements of sorting_methods.c
+//
+// Each distribution fills values[0..n-1] with non-negative integers. The values depend only on n and on the seed (a
+// small pseudo-random generator, splitmix64, is used instead of rand(), so the data does not depend on the C library),
+// so all sorting routines receive exactly the same data. The "random" distribution has no function: the data items are
+// then filled directly with GT_RANDOM, as before (uniformly distributed random keys, covering the whole key range).
+//
+
+#include <math.h>
+#include <string.h>
+#include "sorting_methods.h"
+
+#define FEW_UNIQUE  16 // number of distinct values of the few_unique distribution
+
+static uint32_t next_random(uint64_t *state)
+{ // splitmix64
+  uint64_t z;
+
+  z = (*state += 0x9E3779B97F4A7C15u);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+  return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+static int random_below(uint64_t *state,int m)
+{ // random integer in 0..m-1
+  return (int)(((uint64_t)next_random(state) * (uint64_t)m) >> 32);
+}
+
+static void sorted(int *values,int n,unsigned int seed)
+{
+  int i;
+
+  (void)seed;
+  for(i = 0;i < n;i++)
+    values[i] = i;
+}
+
+static void reverse_sorted(int *values,int n,unsigned int seed)
+{
+  int i;
+
+  (void)seed;
+  for(i = 0;i < n;i++)
+    values[i] = n - 1 - i;
+}
+
+static void nearly_sorted(int *values,int n,unsigned int seed)
+{ // sorted, and then about 1% of the items are swapped with random items
+  uint64_t state = seed;
+  int i,j,k,tmp;
+
+  for(i = 0;i < n;i++)
+    values[i] = i;
+  for(k = (n + 199) / 200;k > 0;k--)
+  {
+    i = random_below(&state,n);
+    j = random_below(&state,n);
+    tmp = values[i];
+    values[i] = values[j];
+    values[j] = tmp;
+  }
+}
+
+static void few_unique(int *values,int n,unsigned int seed)
+{
+  uint64_t state = seed;
+  int i;
+
+  for(i = 0;i < n;i++)
+    values[i] = random_below(&state,FEW_UNIQUE);
+}
+
+static void organ_pipe(int *values,int n,unsigned int seed)
+{ // 0, 1, 2, ..., 2, 1, 0
+  int i;
+
+  (void)seed;
+  for(i = 0;i < n;i++)
+    values[i] = (i < n - i) ? i : n - 1 - i;
+}
+
+static void sawtooth(int *values,int n,unsigned int seed)
+{ // about sqrt(n) ascending runs of about sqrt(n) items each
+  int i,period;
+
+  (void)seed;
+  period = (int)ceil(sqrt((double)n));
+  for(i = 0;i < n;i++)
+    values[i] = i % period;
+}
+
+static void zipf(int *values,int n,unsigned int seed)
+{ // values in 0..n-1, the value k-1 with probability (approximately) proportional to 1/k (Zipf's law with s=1)
+  uint64_t state = seed;
+  double log_n;
+  int i;
+
+  log_n = log((double)n + 1.0);
+  for(i = 0;i < n;i++)
+    values[i] = (int)floor(exp(log_n * (double)next_random(&state) / 4294967296.0)) - 1;
+}
+
+static void narrow_range(int *values,int n,unsigned int seed)
+{ // values in 0..n-1 (a key range as large as the number of items, so counting sort is possible)
+  uint64_t state = seed;
+  int i;
+
+  for(i = 0;i < n;i++)
+    values[i] = random_below(&state,n);
+}
+
+static void all_equal(int *values,int n,unsigned int seed)
+{
+  int i;
+
+  (void)seed;
+  for(i = 0;i < n;i++)
+    values[i] = 0;
+}
+
+static void killer(int *values,int n,unsigned int seed)
+{
+  (void)seed;
+  median_of_3_killer(values,n);
+}
+
+input_distribution_t input_distributions[] =
+{ // function        name              max_n  reuse
+  { NULL,            "random",             0,     0 },
+  { sorted,          "sorted",             0,     0 },
+  { reverse_sorted,  "reverse_sorted",     0,     0 },
+  { nearly_sorted,   "nearly_sorted",      0,     0 },
+  { few_unique,      "few_unique",         0,     0 },
+  { organ_pipe,      "organ_pipe",         0,     0 },
+  { sawtooth,        "sawtooth",           0,     0 },
+  { zipf,            "zipf",               0,     0 },
+  { narrow_range,    "narrow_range",       0,     0 },
+  { all_equal,       "all_equal",          0,     0 },
+  { killer,          "killer",         50000,     1 }  // expensive to compute, so n is limited and it is computed once
+};
+int n_input_distributions = (int)(sizeof(input_distributions) / sizeof(input_distributions[0]));
+
+input_distribution_t *find_input_distribution(char *name)
+{
+  int i;
+
+  for(i = 0;i < n_input_distributions;i++)
+    if(strcmp(name,input_distributions[i].name) == 0)
+      return &input_distributions[i];
+  return NULL;
+}
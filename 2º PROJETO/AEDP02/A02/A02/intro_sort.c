@@ -0,0 +1,240 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// introspective quick sort (in the style of pattern-defeating quick sort)
+//
+// Differences to quick_sort():
+//   * the pivot is the median of three (small ranges) or a pseudo-median of nine (large ranges)
+//   * the recursion depth is limited to 2*log2(n), and the number of very unbalanced partitions to log2(n); if one
+//     of these limits is reached the range is sorted by heap_sort(), so the worst case is O(n log n)
+//   * after a very unbalanced partition some items are swapped, to break patterns that fool the pivot selection
+//   * only the smaller side of a partition is sorted recursively (the stack depth is at most log2(n))
+//   * an already sorted or reversed array takes O(n) time; if a partition did not move any item, both sides are
+//     given to an insertion sort that gives up after moving a few items (nearly sorted data)
+//   * ranges whose pivot is equal to the pivot of the parent range (many duplicates) are partitioned into "equal"
+//     and "larger", and the "equal" part is done
+//
+
+#include "sorting_methods.h"
+
+#define INSERTION_SORT_LIMIT   24  // ranges smaller than this are sorted by insertion sort
+#define NINTHER_LIMIT         128  // ranges larger than this use a pseudo-median of nine
+#define PARTIAL_LIMIT           8  // partial insertion sort gives up after moving this many items
+
+#define SWAP(i,j)  do { T tmp_ = data[i]; data[i] = data[j]; data[j] = tmp_; } while(0)
+#define SORT2(i,j) do if(data[j] < data[i]) SWAP(i,j); while(0)
+#define SORT3(i,j,k) do { SORT2(i,j); SORT2(j,k); SORT2(i,j); } while(0)
+
+//
+// insertion sort that gives up (returning 0) when more than PARTIAL_LIMIT items were moved
+//
+static int partial_insertion_sort(T *data,int first,int one_after_last)
+{
+  int i,j,moved;
+  T tmp;
+
+  for(i = first + 1,moved = 0;i < one_after_last;i++)
+  {
+    if(moved > PARTIAL_LIMIT)
+      return 0;
+    tmp = data[i];
+    for(j = i;j > first && tmp < data[j - 1];j--)
+      data[j] = data[j - 1];
+    data[j] = tmp;
+    moved += i - j;
+  }
+  return 1;
+}
+
+//
+// partition around the pivot data[first]; items equal to the pivot go to the right
+// the return value is the final position of the pivot; *no_swaps is set to 1 if the range was already partitioned
+//
+static int partition_right(T *data,int first,int one_after_last,int *no_swaps)
+{
+  int i,j;
+  T pivot;
+
+  pivot = data[first];
+  i = first;
+  j = one_after_last;
+  while(data[++i] < pivot)  // stops at one_after_last - 1 at the latest (the pivot selection places an item
+    ;                       //   not smaller than the pivot there)
+  if(i - 1 == first)
+    while(i < j && !(data[--j] < pivot))
+      ;
+  else
+    while(!(data[--j] < pivot)) // stops at or before i - 1
+      ;
+  *no_swaps = (i >= j);
+  while(i < j)
+  {
+    SWAP(i,j);
+    while(data[++i] < pivot)
+      ;
+    while(!(data[--j] < pivot))
+      ;
+  }
+  data[first] = data[i - 1];
+  data[i - 1] = pivot;
+  return i - 1;
+}
+
+//
+// partition around the pivot data[first]; items equal to the pivot go to the left (the return value is the final
+// position of the pivot)
+//
+static int partition_left(T *data,int first,int one_after_last)
+{
+  int i,j;
+  T pivot;
+
+  pivot = data[first];
+  i = first;
+  j = one_after_last;
+  while(pivot < data[--j])  // stops at first at the latest
+    ;
+  if(j + 1 == one_after_last)
+    while(i < j && !(pivot < data[++i]))
+      ;
+  else
+    while(!(pivot < data[++i]))
+      ;
+  while(i < j)
+  {
+    SWAP(i,j);
+    while(pivot < data[--j])
+      ;
+    while(!(pivot < data[++i]))
+      ;
+  }
+  data[first] = data[j];
+  data[j] = pivot;
+  return j;
+}
+
+//
+// sort data[first..one_after_last-1]; leftmost is 0 if data[first-1] is the pivot of an enclosing range
+//
+static void intro_sort_loop(T *data,int first,int one_after_last,int depth_limit,int bad_allowed,int leftmost)
+{
+  int n,half,pivot_pos,l_size,r_size,no_swaps;
+
+  for(;;)
+  {
+    n = one_after_last - first;
+    if(n < INSERTION_SORT_LIMIT)
+    {
+      insertion_sort(data,first,one_after_last);
+      return;
+    }
+    if(depth_limit-- == 0)
+    {
+      heap_sort(data,first,one_after_last);
+      return;
+    }
+    //
+    // pivot selection (the pivot goes to data[first])
+    //
+    half = n / 2;
+    if(n > NINTHER_LIMIT)
+    {
+      SORT3(first,first + half,one_after_last - 1);
+      SORT3(first + 1,first + half - 1,one_after_last - 2);
+      SORT3(first + 2,first + half + 1,one_after_last - 3);
+      SORT3(first + half - 1,first + half,first + half + 1);
+      SWAP(first,first + half);
+    }
+    else
+      SORT3(first + half,first,one_after_last - 1);
+    //
+    // many items equal to the pivot of the enclosing range (which is not larger than any item of this range)
+    //
+    if(leftmost == 0 && !(data[first - 1] < data[first]))
+    {
+      first = partition_left(data,first,one_after_last) + 1;
+      continue;
+    }
+    //
+    // partition
+    //
+    pivot_pos = partition_right(data,first,one_after_last,&no_swaps);
+    l_size = pivot_pos - first;
+    r_size = one_after_last - (pivot_pos + 1);
+    if(l_size < n / 8 || r_size < n / 8)
+    { // very unbalanced partition
+      if(--bad_allowed == 0)
+      {
+        heap_sort(data,first,one_after_last);
+        return;
+      }
+      if(l_size >= INSERTION_SORT_LIMIT)
+      {
+        SWAP(first,first + l_size / 4);
+        SWAP(pivot_pos - 1,pivot_pos - l_size / 4);
+        if(l_size > NINTHER_LIMIT)
+        {
+          SWAP(first + 1,first + (l_size / 4 + 1));
+          SWAP(first + 2,first + (l_size / 4 + 2));
+          SWAP(pivot_pos - 2,pivot_pos - (l_size / 4 + 1));
+          SWAP(pivot_pos - 3,pivot_pos - (l_size / 4 + 2));
+        }
+      }
+      if(r_size >= INSERTION_SORT_LIMIT)
+      {
+        SWAP(pivot_pos + 1,pivot_pos + (1 + r_size / 4));
+        SWAP(one_after_last - 1,one_after_last - r_size / 4);
+        if(r_size > NINTHER_LIMIT)
+        {
+          SWAP(pivot_pos + 2,pivot_pos + (2 + r_size / 4));
+          SWAP(pivot_pos + 3,pivot_pos + (3 + r_size / 4));
+          SWAP(one_after_last - 2,one_after_last - (1 + r_size / 4));
+          SWAP(one_after_last - 3,one_after_last - (2 + r_size / 4));
+        }
+      }
+    }
+    else if(no_swaps != 0 && partial_insertion_sort(data,first,pivot_pos) != 0 && partial_insertion_sort(data,pivot_pos + 1,one_after_last) != 0)
+      return; // nearly sorted data
+    //
+    // recurse on the smaller side, iterate on the larger one
+    //
+    if(l_size < r_size)
+    {
+      intro_sort_loop(data,first,pivot_pos,depth_limit,bad_allowed,leftmost);
+      first = pivot_pos + 1;
+      leftmost = 0;
+    }
+    else
+    {
+      intro_sort_loop(data,pivot_pos + 1,one_after_last,depth_limit,bad_allowed,0);
+      one_after_last = pivot_pos;
+    }
+  }
+}
+
+void intro_sort(T *data,int first,int one_after_last)
+{
+  int i,j,log2_n;
+
+  //
+  // already sorted or reversed data
+  //
+  for(i = first + 1;i < one_after_last && !(data[i] < data[i - 1]);i++)
+    ;
+  if(i >= one_after_last)
+    return;
+  if(i == first + 1)
+  {
+    for(i = first + 1;i < one_after_last && data[i] < data[i - 1];i++)
+      ;
+    if(i >= one_after_last)
+    { // strictly decreasing, reverse it
+      for(i = first,j = one_after_last - 1;i < j;i++,j--)
+        SWAP(i,j);
+      return;
+    }
+  }
+  for(log2_n = 0;(one_after_last - first) >> log2_n > 1;log2_n++)
+    ;
+  intro_sort_loop(data,first,one_after_last,2 * log2_n,log2_n,1);
+}
@@ -0,0 +1,71 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// adversarial input for quick_sort() (median of three killer)
+//
+// M. D. McIlroy's "A killer adversary for quicksort" (1999): the sorting routine sorts item numbers, and the comparison
+// function gives values to the items only when it has to. Items that have not been compared in a meaningful way yet
+// are "gas" (larger than all values given so far); when two gas items are compared, one of them (preferably the one
+// that looks like a pivot candidate) is "frozen" with the smallest value not yet used. Once the sort ends, the values
+// of the items are an input that makes the sorting routine take the same decisions, i.e., quadratic time.
+//
+// The sorting routine used here is the int instance of the quick_sort of sorting_methods_template.h, which takes the
+// same decisions as quick_sort(). It does about n^2/4 comparisons, so this is only practical for n up to about 10^5.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sorting_methods.h"
+
+static int *killer_value;  // killer_value[item]
+static int killer_gas;     // value of the gas items (n)
+static int killer_n_solid; // number of frozen items
+static int killer_candidate;
+
+static int killer_compare(int x,int y)
+{
+  if(killer_value[x] == killer_gas && killer_value[y] == killer_gas)
+    killer_value[(x == killer_candidate) ? x : y] = killer_n_solid++; // freeze one of them
+  if(killer_value[x] == killer_gas)
+    killer_candidate = x;
+  else if(killer_value[y] == killer_gas)
+    killer_candidate = y;
+  return killer_value[x] - killer_value[y];
+}
+
+#define GT            int
+#define GT_SUFFIX     killer
+#define GT_LESS(a,b)  (killer_compare(a,b) < 0)
+#include "sorting_methods_template.h"
+#undef GT
+#undef GT_SUFFIX
+#undef GT_LESS
+
+//
+// values[0..n-1] becomes a permutation of 0..n-1 for which quick_sort() does about n^2/4 comparisons
+//
+void median_of_3_killer(int *values,int n)
+{
+  int i,*items;
+
+  items = (int *)malloc((size_t)n * sizeof(int));
+  if(items == NULL)
+  {
+    fprintf(stderr,"median_of_3_killer: unable to allocate memory --- 😒\n");
+    exit(1);
+  }
+  killer_value = values;
+  killer_gas = n;
+  killer_n_solid = 0;
+  killer_candidate = 0;
+  for(i = 0;i < n;i++)
+  {
+    values[i] = killer_gas;
+    items[i] = i;
+  }
+  quick_sort_killer(items,0,n);
+  for(i = 0;i < n;i++)
+    if(values[i] == killer_gas)
+      values[i] = killer_n_solid++; // freeze the remaining gas items
+  free(items);
+}
@@ -14,7 +14,7 @@ void merge_sort(T *data,int first,int one_after_last)
     insertion_sort(data,first,one_after_last);
   else
   {
-    middle = (first + one_after_last) / 2;
+    middle = first + (one_after_last - first) / 2;
     merge_sort(data,first,middle);
     merge_sort(data,middle,one_after_last);
     buffer = (T *)malloc((size_t)(one_after_last - first) * sizeof(T)) - first; // no error check!
@@ -0,0 +1,66 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// bottom-up merge sort (no recursion, and at most one memory allocation)
+//
+// Runs of RUN_SIZE items are sorted with insertion sort, and then pairs of adjacent runs are merged, each pass going
+// from the data array to the buffer or the other way around (nothing is copied back). When the number of passes is
+// odd the runs are made twice as small, so that the last pass always ends up in the data array. The runs are merged by
+// merge_simd().
+//
+
+#include <stdlib.h>
+#include "sorting_methods.h"
+
+#define RUN_SIZE  32
+
+//
+// buffer must have room for one_after_last - first items (buffer[0] is used as the companion of data[first])
+//
+void merge_sort_bottom_up_buffer(T *data,int first,int one_after_last,T *buffer)
+{
+  int i,n,w,run_size,n_passes,middle,end;
+  T *src,*dst,*tmp;
+
+  n = one_after_last - first;
+  run_size = RUN_SIZE;
+  for(n_passes = 0,w = run_size;w < n;w = (w <= n / 2) ? 2 * w : n)
+    n_passes++;
+  if(n_passes % 2 != 0)
+    run_size /= 2; // one more pass
+  src = data + first;
+  dst = buffer;
+  for(i = 0;i < n;i += run_size)
+    insertion_sort(src,i,(n - i > run_size) ? i + run_size : n);
+  for(w = run_size;w < n;w = (w <= n / 2) ? 2 * w : n)
+  {
+    for(i = 0;i < n;i = end)
+    { // merge src[i..middle-1] and src[middle..end-1] into dst[i..end-1]
+      middle = (n - i > w) ? i + w : n;
+      end = (n - middle > w) ? middle + w : n;
+      merge_simd(&src[i],middle - i,&src[middle],end - middle,&dst[i]);
+    }
+    tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+}
+
+void merge_sort_bottom_up(T *data,int first,int one_after_last)
+{
+  T *buffer;
+
+  if(one_after_last - first <= RUN_SIZE)
+  { // no merges
+    insertion_sort(data,first,one_after_last);
+    return;
+  }
+  buffer = (T *)malloc((size_t)(one_after_last - first) * sizeof(T));
+  if(buffer == NULL)
+  { // not enough memory for the buffer, use an in-place sort
+    heap_sort(data,first,one_after_last);
+    return;
+  }
+  merge_sort_bottom_up_buffer(data,first,one_after_last,buffer);
+  free(buffer);
+}
@@ -0,0 +1,113 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// selection: nth_element(), partial_sort(), and top_k()
+//
+// nth_element() is an introspective quick select: it partitions the range with quick_sort_partition() (median of
+// three, 3-way) and continues only on the side that contains the nth position, so it takes O(n) time on average.
+// After 2*log2(n) partitions that did not finish the job (bad luck, or an adversary such as median_of_3_killer())
+// the pivot is chosen by the median of medians method (groups of five), which guarantees that each partition
+// discards at least 3/10 of the items, so the worst case is also O(n).
+//
+// partial_sort() and top_k() select first and then sort only the selected items, in O(n+k*log(k)) time, instead of
+// the O(n*log(n)) time of a full sort.
+//
+
+#include "sorting_methods.h"
+
+#define INSERTION_SORT_LIMIT  20  // ranges smaller than this are sorted by insertion sort
+
+#define SWAP(i,j)  do { T tmp_ = data[i]; data[i] = data[j]; data[j] = tmp_; } while(0)
+
+static void select_nth(T *data,int first,int nth,int one_after_last,int budget);
+
+//
+// median of medians pivot, placed at data[one_after_last-1]
+//
+static void median_of_medians(T *data,int first,int one_after_last)
+{
+  int i,g,end;
+
+  for(i = first,g = first;i < one_after_last;i += 5,g++)
+  { // sort each group of (at most) five items and move its median to data[g]
+    end = (one_after_last - i > 5) ? i + 5 : one_after_last;
+    insertion_sort(data,i,end);
+    SWAP(g,i + (end - i - 1) / 2);
+  }
+  select_nth(data,first,first + (g - first) / 2,g,0); // the median of the medians (no quick partitions here)
+  SWAP(first + (g - first) / 2,one_after_last - 1);
+}
+
+//
+// quick select; after budget partitions the pivot is chosen by the median of medians method
+//
+static void select_nth(T *data,int first,int nth,int one_after_last,int budget)
+{
+  int first_equal,one_after_equal;
+
+  while(one_after_last - first >= INSERTION_SORT_LIMIT)
+  {
+    if(budget > 0)
+    {
+      budget--;
+      quick_sort_partition(data,first,one_after_last,&first_equal,&one_after_equal);
+    }
+    else
+    {
+      median_of_medians(data,first,one_after_last);
+      three_way_partition(data,first,one_after_last,&first_equal,&one_after_equal);
+    }
+    if(nth < first_equal)
+      one_after_last = first_equal;
+    else if(nth >= one_after_equal)
+      first = one_after_equal;
+    else
+      return; // data[nth] is equal to the pivot
+  }
+  insertion_sort(data,first,one_after_last);
+}
+
+//
+// rearrange data[first..one_after_last-1] so that data[nth] is the item that would be there if the range were
+// sorted, the items before it are not larger, and the items after it are not smaller
+//
+void nth_element(T *data,int first,int nth,int one_after_last)
+{
+  int n,budget;
+
+  if(nth < first || nth >= one_after_last)
+    return;
+  for(n = one_after_last - first,budget = 0;n > 1;n >>= 1)
+    budget += 2;
+  select_nth(data,first,nth,one_after_last,budget);
+}
+
+//
+// the smallest middle-first items of data[first..one_after_last-1], sorted, are placed in data[first..middle-1]
+// (the order of the other items is unspecified)
+//
+void partial_sort(T *data,int first,int middle,int one_after_last)
+{
+  if(middle <= first)
+    return;
+  if(middle < one_after_last)
+    nth_element(data,first,middle - 1,one_after_last);
+  else
+    middle = one_after_last;
+  intro_sort(data,first,middle);
+}
+
+//
+// the k largest items of data[first..one_after_last-1], sorted, are placed in data[one_after_last-k..one_after_last-1]
+// (the order of the other items is unspecified)
+//
+void top_k(T *data,int first,int one_after_last,int k)
+{
+  if(k <= 0)
+    return;
+  if(k < one_after_last - first)
+    nth_element(data,first,one_after_last - k,one_after_last);
+  else
+    k = one_after_last - first;
+  intro_sort(data,one_after_last - k,one_after_last);
+}
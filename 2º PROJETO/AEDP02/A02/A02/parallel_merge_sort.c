@@ -0,0 +1,145 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// parallel merge sort
+//
+// Phase 1: the array is split into p chunks (p is the number of threads), and each thread sorts its chunk (with
+//          merge_sort_bottom_up_buffer(), using its part of the buffer).
+// Phase 2: ceil(log2(p)) rounds of pairwise merges of adjacent runs, ping-ponging between the data array and a
+//          buffer. In each round thread t produces the items [t*n/p,(t+1)*n/p) of the output, whatever runs they
+//          belong to; the corresponding parts of the two input runs are found by a binary search on the merge path
+//          (co-rank), so the work is evenly split no matter how the data is distributed. The parts are merged by
+//          merge_simd().
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "sorting_methods.h"
+
+#define MIN_ITEMS_PER_THREAD  256 // use fewer threads for small arrays
+
+typedef struct
+{
+  T *data;                     // data to be sorted (data[0] is the first item)
+  T *buffer;                   // buffer with room for n items
+  int n;                       // number of items
+  int p;                       // number of threads
+  int id;                      // thread number
+  pthread_barrier_t *barrier;  // all threads wait here at the end of each phase/round
+}
+pms_thread_t;
+
+//
+// position (index) of the first item of chunk c
+//
+static int chunk_start(int n,int p,int c)
+{
+  return (int)((long long)c * (long long)n / (long long)p);
+}
+
+//
+// return the number i of items of a that go into the first k items of the (stable) merge of a[0..m-1] and b[0..l-1]
+//
+static int co_rank(int k,T *a,int m,T *b,int l)
+{
+  int i,i_low,i_high;
+
+  i_low = (k > l) ? k - l : 0;
+  i_high = (k < m) ? k : m;
+  while(i_low < i_high)
+  {
+    i = i_low + (i_high - i_low) / 2;
+    if(a[i] <= b[k - i - 1])
+      i_low = i + 1;  // a[i] goes before b[k-i-1], so more items of a are needed
+    else
+      i_high = i;
+  }
+  return i_low;
+}
+
+static void *pms_thread(void *arg)
+{
+  pms_thread_t *t = (pms_thread_t *)arg;
+  int n,p,w,g,lo,hi,left,middle,right,k0,k1,i0,i1;
+  T *src,*dst,*tmp;
+
+  n = t->n;
+  p = t->p;
+  //
+  // phase 1: sort the chunk of this thread
+  //
+  lo = chunk_start(n,p,t->id);     // this thread's chunk (and part of the output)
+  hi = chunk_start(n,p,t->id + 1);
+  merge_sort_bottom_up_buffer(t->data,lo,hi,t->buffer + lo);
+  pthread_barrier_wait(t->barrier);
+  //
+  // phase 2: merge runs of w chunks
+  //
+  src = t->data;
+  dst = t->buffer;
+  for(w = 1;w < p;w *= 2)
+  {
+    for(g = 0;g < p;g += 2 * w)
+    { // runs [left,middle) and [middle,right)
+      left = chunk_start(n,p,g);
+      middle = chunk_start(n,p,(g + w < p) ? g + w : p);
+      right = chunk_start(n,p,(g + 2 * w < p) ? g + 2 * w : p);
+      k0 = (lo > left) ? lo : left;
+      k1 = (hi < right) ? hi : right;
+      if(k0 >= k1)
+        continue; // nothing to do here
+      i0 = co_rank(k0 - left,src + left,middle - left,src + middle,right - middle);
+      i1 = co_rank(k1 - left,src + left,middle - left,src + middle,right - middle);
+      merge_simd(src + left + i0,i1 - i0,src + middle + (k0 - left - i0),(k1 - left - i1) - (k0 - left - i0),dst + k0);
+    }
+    tmp = src;
+    src = dst;
+    dst = tmp;
+    pthread_barrier_wait(t->barrier);
+  }
+  if(src != t->data)
+    memcpy(t->data + lo,src + lo,(size_t)(hi - lo) * sizeof(T));
+  return NULL;
+}
+
+void parallel_merge_sort(T *data,int first,int one_after_last)
+{
+  pms_thread_t threads[MAX_SORT_THREADS];
+  pthread_t thread_ids[MAX_SORT_THREADS];
+  pthread_barrier_t barrier;
+  int i,n,p;
+  T *buffer;
+
+  n = one_after_last - first;
+  p = sort_threads();
+  if(p > n / MIN_ITEMS_PER_THREAD)
+    p = n / MIN_ITEMS_PER_THREAD;
+  if(p <= 1 || (buffer = (T *)malloc((size_t)n * sizeof(T))) == NULL)
+  { // not worth it (or no memory for the buffer)
+    merge_sort_simd(data,first,one_after_last);
+    return;
+  }
+  pthread_barrier_init(&barrier,NULL,(unsigned int)p);
+  for(i = 0;i < p;i++)
+  {
+    threads[i].data = data + first;
+    threads[i].buffer = buffer;
+    threads[i].n = n;
+    threads[i].p = p;
+    threads[i].id = i;
+    threads[i].barrier = &barrier;
+  }
+  for(i = 1;i < p;i++)
+    if(pthread_create(&thread_ids[i],NULL,pms_thread,(void *)&threads[i]) != 0)
+    {
+      fprintf(stderr,"parallel_merge_sort: unable to create thread --- 😒\n");
+      exit(1);
+    }
+  (void)pms_thread((void *)&threads[0]); // the calling thread is thread 0
+  for(i = 1;i < p;i++)
+    pthread_join(thread_ids[i],NULL);
+  pthread_barrier_destroy(&barrier);
+  free(buffer);
+}
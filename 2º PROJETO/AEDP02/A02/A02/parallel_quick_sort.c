@@ -0,0 +1,367 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// parallel (in-place) quick sort
+//
+// Phase 1: while a range is large, a team of threads partitions it in parallel (each thread partitions a block of the
+//          range, and then the misplaced items are swapped, also in parallel); the team is then split in two, one
+//          half for each side of the partition.
+// Phase 2: when a thread is alone (or the range is too small for its team), the range becomes a task of its
+//          work-stealing deque. A thread partitions its task with quick_sort_partition(), pushes the larger side
+//          onto the bottom of its deque and goes on with the smaller side; small ranges are sorted with intro_sort().
+//          As in intro_sort(), the number of partitions above a task is limited to about 2*log2(n); a task that
+//          reaches the limit is sorted with heap_sort(), so the worst case is O(n log n) (and the recursion depth
+//          of a thread is bounded).
+//          A thread with an empty deque steals the task at the top (the oldest, and so the largest) of another deque.
+// The threads stop when all items are known to be in their final positions.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "sorting_methods.h"
+
+#define MIN_ITEMS_PER_THREAD     (1 << 16) // a team of q threads partitions ranges with at least q times this items
+#define SEQUENTIAL_CUTOFF        (1 << 13) // tasks with at most this number of items are sorted by intro_sort()
+#define DEQUE_SIZE               64        // (deque full, which is very unlikely, means sort the task right away)
+#define MAX_TEAMS                (4 * MAX_SORT_THREADS)
+
+typedef struct
+{
+  int first;
+  int one_after_last;
+  int depth;       // number of partitions still allowed
+}
+pqs_task_t;
+
+typedef struct
+{
+  pthread_mutex_t lock;
+  int top;                      // index of the oldest task (stolen by other threads)
+  int bottom;                   // index of the newest task plus one (pushed and popped by the owner)
+  pqs_task_t tasks[DEQUE_SIZE];
+}
+pqs_deque_t;
+
+static struct
+{
+  T *data;                                // data to be sorted (data[0] is the first item)
+  int n;                                  // number of items
+  int p;                                  // number of threads
+  atomic_long remaining;                  // number of items not yet known to be in their final positions
+  pqs_deque_t deques[MAX_SORT_THREADS];
+  pthread_barrier_t barriers[MAX_TEAMS];  // team barriers, indexed as the nodes of a binary heap (root team: 1)
+  int mid[MAX_SORT_THREADS];              // results of the block partitions of a team
+}
+pqs;
+
+
+//
+// work-stealing deques
+//
+
+static int push_task(int t,int first,int one_after_last,int depth)
+{
+  pqs_deque_t *d = &pqs.deques[t];
+  int ok;
+
+  pthread_mutex_lock(&d->lock);
+  if((ok = (d->bottom < DEQUE_SIZE)) != 0)
+  {
+    d->tasks[d->bottom].first = first;
+    d->tasks[d->bottom].one_after_last = one_after_last;
+    d->tasks[d->bottom].depth = depth;
+    d->bottom++;
+  }
+  pthread_mutex_unlock(&d->lock);
+  return ok;
+}
+
+static int pop_task(int t,int steal,pqs_task_t *task)
+{
+  pqs_deque_t *d = &pqs.deques[t];
+  int ok;
+
+  pthread_mutex_lock(&d->lock);
+  if((ok = (d->top < d->bottom)) != 0)
+  {
+    *task = (steal != 0) ? d->tasks[d->top++] : d->tasks[--d->bottom];
+    if(d->top == d->bottom)
+      d->top = d->bottom = 0;
+  }
+  pthread_mutex_unlock(&d->lock);
+  return ok;
+}
+
+
+//
+// parallel 2-way partition of data[first..one_after_last-1] by the team of threads t0..t0+q-1 (t is the caller)
+// the items x with x < pivot (strict != 0) or with x <= pivot (strict == 0) go to the left; the return value is the
+// index of the first item of the right part
+//
+
+static int left_item(T x,T pivot,int strict)
+{
+  return (strict != 0) ? (x < pivot) : (x <= pivot);
+}
+
+static int parallel_partition(int t,int t0,int q,int team,int first,int one_after_last,T pivot,int strict)
+{
+  int i,j,lo,hi,middle,n_intervals[2],c,k,k_end,ia,ib,pa,pb;
+  int intervals[2][MAX_SORT_THREADS][2]; // the misplaced items: [0] on the left side, [1] on the right side
+  T *data = pqs.data,tmp;
+
+# define BLOCK_START(b)  (first + (int)((long long)(b) * (long long)(one_after_last - first) / (long long)q))
+  //
+  // partition the block of this thread
+  //
+  i = lo = BLOCK_START(t - t0);
+  j = hi = BLOCK_START(t - t0 + 1);
+  for(;;)
+  {
+    while(i < j && left_item(data[i],pivot,strict) != 0)
+      i++;
+    while(i < j && left_item(data[j - 1],pivot,strict) == 0)
+      j--;
+    if(i >= j)
+      break;
+    tmp = data[i];
+    data[i] = data[j - 1];
+    data[j - 1] = tmp;
+    i++;
+    j--;
+  }
+  pqs.mid[t] = i;
+  pthread_barrier_wait(&pqs.barriers[team]);
+  //
+  // all threads of the team find (the same) misplaced items: right items before middle and left items after it
+  //
+  middle = first;
+  for(c = 0;c < q;c++)
+    middle += pqs.mid[t0 + c] - BLOCK_START(c);
+  n_intervals[0] = n_intervals[1] = 0;
+  for(c = 0;c < q;c++)
+  {
+    lo = BLOCK_START(c);
+    hi = BLOCK_START(c + 1);
+    i = (pqs.mid[t0 + c] > first) ? pqs.mid[t0 + c] : first; // right items of block c placed before middle
+    j = (hi < middle) ? hi : middle;
+    if(i < j)
+    {
+      intervals[0][n_intervals[0]][0] = i;
+      intervals[0][n_intervals[0]++][1] = j;
+    }
+    i = (lo > middle) ? lo : middle; // left items of block c placed after middle
+    j = pqs.mid[t0 + c];
+    if(i < j)
+    {
+      intervals[1][n_intervals[1]][0] = i;
+      intervals[1][n_intervals[1]++][1] = j;
+    }
+  }
+  //
+  // swap the misplaced items (thread t takes care of its share of them)
+  //
+  for(c = k = 0;c < n_intervals[0];c++)
+    k += intervals[0][c][1] - intervals[0][c][0];
+  k_end = (int)((long long)(t - t0 + 1) * (long long)k / (long long)q);
+  k = (int)((long long)(t - t0) * (long long)k / (long long)q);
+  for(ia = 0,pa = k;ia < n_intervals[0] && pa >= intervals[0][ia][1] - intervals[0][ia][0];ia++)
+    pa -= intervals[0][ia][1] - intervals[0][ia][0];
+  for(ib = 0,pb = k;ib < n_intervals[1] && pb >= intervals[1][ib][1] - intervals[1][ib][0];ib++)
+    pb -= intervals[1][ib][1] - intervals[1][ib][0];
+  for(;k < k_end;k++)
+  {
+    i = intervals[0][ia][0] + pa;
+    j = intervals[1][ib][0] + pb;
+    tmp = data[i];
+    data[i] = data[j];
+    data[j] = tmp;
+    if(++pa == intervals[0][ia][1] - intervals[0][ia][0])
+    {
+      ia++;
+      pa = 0;
+    }
+    if(++pb == intervals[1][ib][1] - intervals[1][ib][0])
+    {
+      ib++;
+      pb = 0;
+    }
+  }
+  pthread_barrier_wait(&pqs.barriers[team]);
+  return middle;
+# undef BLOCK_START
+}
+
+
+//
+// sort a task (and its subtasks)
+//
+
+static int depth_limit(int n)
+{ // about 2*log2(n)
+  int depth;
+
+  for(depth = 0;n > 1;n >>= 1)
+    depth += 2;
+  return depth;
+}
+
+static void sort_task(int t,int first,int one_after_last,int depth)
+{
+  int first_equal,one_after_equal;
+
+  while(one_after_last - first > SEQUENTIAL_CUTOFF)
+  {
+    if(depth-- <= 0)
+    { // depth limit reached (quick_sort_partition() was fooled too often)
+      heap_sort(pqs.data,first,one_after_last);
+      atomic_fetch_sub(&pqs.remaining,(long)(one_after_last - first));
+      return;
+    }
+    quick_sort_partition(pqs.data,first,one_after_last,&first_equal,&one_after_equal);
+    atomic_fetch_sub(&pqs.remaining,(long)(one_after_equal - first_equal));
+    if(first_equal - first > one_after_last - one_after_equal)
+    { // push the left side (the larger one)
+      if(push_task(t,first,first_equal,depth) == 0)
+        sort_task(t,first,first_equal,depth);
+      first = one_after_equal;
+    }
+    else
+    { // push the right side
+      if(push_task(t,one_after_equal,one_after_last,depth) == 0)
+        sort_task(t,one_after_equal,one_after_last,depth);
+      one_after_last = first_equal;
+    }
+  }
+  intro_sort(pqs.data,first,one_after_last);
+  atomic_fetch_sub(&pqs.remaining,(long)(one_after_last - first));
+}
+
+
+//
+// the work of each thread
+//
+
+static void *pqs_thread(void *arg)
+{
+  int t = (int)(long)arg,t0,q,team,first,one_after_last,first_equal,one_after_equal,depth,i;
+  unsigned int seed = 1u + (unsigned int)t;
+  pqs_task_t task;
+  T a,b,c,pivot;
+
+  //
+  // phase 1: team partitions
+  //
+  t0 = 0;
+  q = pqs.p;
+  team = 1;
+  first = 0;
+  one_after_last = pqs.n;
+  depth = depth_limit(pqs.n);
+  while(q > 1 && one_after_last - first >= q * MIN_ITEMS_PER_THREAD)
+  {
+    a = pqs.data[first]; // median of three (the same as quick_sort_partition(), but without moving items)
+    b = pqs.data[first + (one_after_last - first) / 2];
+    c = pqs.data[one_after_last - 1];
+    pivot = (a < b) ? ((b < c) ? b : (a < c) ? c : a) : ((a < c) ? a : (b < c) ? c : b);
+    pthread_barrier_wait(&pqs.barriers[team]); // all threads of the team must use the same pivot
+    first_equal = parallel_partition(t,t0,q,team,first,one_after_last,pivot,1);
+    one_after_equal = parallel_partition(t,t0,q,team,first_equal,one_after_last,pivot,0);
+    depth--;
+    if(t == t0)
+      atomic_fetch_sub(&pqs.remaining,(long)(one_after_equal - first_equal));
+    if(t < t0 + q / 2)
+    { // left team, left side
+      q = q / 2;
+      team = 2 * team;
+      one_after_last = first_equal;
+    }
+    else
+    { // right team, right side
+      t0 += q / 2;
+      q -= q / 2;
+      team = 2 * team + 1;
+      first = one_after_equal;
+    }
+  }
+  if(t == t0)
+    sort_task(t,first,one_after_last,depth);
+  //
+  // phase 2: work stealing
+  //
+  while(atomic_load(&pqs.remaining) > 0L)
+    if(pop_task(t,0,&task) != 0)
+      sort_task(t,task.first,task.one_after_last,task.depth);
+    else
+    {
+      for(i = 0;i < pqs.p;i++)
+        if(pop_task((t + 1 + (int)(rand_r(&seed) % (unsigned int)pqs.p) + i) % pqs.p,1,&task) != 0)
+          break;
+      if(i < pqs.p)
+        sort_task(t,task.first,task.one_after_last,task.depth);
+      else
+        sched_yield();
+    }
+  return NULL;
+}
+
+static void init_team_barriers(int team,int q)
+{
+  if(q > 1)
+  {
+    pthread_barrier_init(&pqs.barriers[team],NULL,(unsigned int)q);
+    init_team_barriers(2 * team,q / 2);
+    init_team_barriers(2 * team + 1,q - q / 2);
+  }
+}
+
+static void destroy_team_barriers(int team,int q)
+{
+  if(q > 1)
+  {
+    pthread_barrier_destroy(&pqs.barriers[team]);
+    destroy_team_barriers(2 * team,q / 2);
+    destroy_team_barriers(2 * team + 1,q - q / 2);
+  }
+}
+
+void parallel_quick_sort(T *data,int first,int one_after_last)
+{
+  static pthread_mutex_t busy = PTHREAD_MUTEX_INITIALIZER; // pqs is shared; one parallel_quick_sort() at a time
+  pthread_t thread_ids[MAX_SORT_THREADS];
+  int i,p;
+
+  p = sort_threads();
+  if(p <= 1 || one_after_last - first <= SEQUENTIAL_CUTOFF)
+  { // not worth it
+    intro_sort(data,first,one_after_last);
+    return;
+  }
+  pthread_mutex_lock(&busy);
+  pqs.data = data + first;
+  pqs.n = one_after_last - first;
+  pqs.p = p;
+  atomic_store(&pqs.remaining,(long)(one_after_last - first));
+  for(i = 0;i < p;i++)
+  {
+    pthread_mutex_init(&pqs.deques[i].lock,NULL);
+    pqs.deques[i].top = pqs.deques[i].bottom = 0;
+  }
+  init_team_barriers(1,p);
+  for(i = 1;i < p;i++)
+    if(pthread_create(&thread_ids[i],NULL,pqs_thread,(void *)(long)i) != 0)
+    {
+      fprintf(stderr,"parallel_quick_sort: unable to create thread --- 😒\n");
+      exit(1);
+    }
+  (void)pqs_thread((void *)0L); // the calling thread is thread 0
+  for(i = 1;i < p;i++)
+    pthread_join(thread_ids[i],NULL);
+  destroy_team_barriers(1,p);
+  for(i = 0;i < p;i++)
+    pthread_mutex_destroy(&pqs.deques[i].lock);
+  pthread_mutex_unlock(&busy);
+}
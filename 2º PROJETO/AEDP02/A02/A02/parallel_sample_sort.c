@@ -0,0 +1,315 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// parallel sample sort (in the style of super scalar sample sort, P. Sanders and S. Winkel, 2004)
+//
+// Phase 1: OVERSAMPLING*B items are sampled and sorted, and B-1 evenly spaced items of the sample become the
+//          splitters of B buckets (B is a power of two, about BUCKETS_PER_THREAD buckets per thread). The splitters
+//          are stored as an implicit binary search tree (the children of node j are 2j and 2j+1), so that the bucket
+//          of an item is found in log2(B) steps without conditional branches (j = 2*j + (tree[j] < x)).
+// Phase 2: each thread classifies the items of its chunk of the array, storing the bucket numbers in an "oracle"
+//          array and counting the items of each bucket.
+// Phase 3: thread 0 turns the counts into the positions, in the buffer, where each thread places the items of each
+//          bucket, and gives each thread consecutive buckets with about n/p items in all.
+// Phase 4: each thread touches the part of the buffer that will hold its buckets, and then moves the items of its
+//          chunk to the buffer; the items go first to small per-bucket local buffers, of one cache line each, which
+//          are copied to the buffer when they are full (so the writes to the buffer are of whole cache lines).
+// Phase 5: each thread sorts its buckets with radix_sort() and copies them back to the data array.
+//
+// NUMA: the threads are pinned to the processors (thread t to the t-th processor the process may use), and the pages
+// of the buffer are placed, by the operating system, in the memory node of the thread that touches them first, so
+// each thread sorts its buckets in the memory attached to its own processor (no libnuma is needed for this).
+//
+
+#if defined(__linux__)
+# define _GNU_SOURCE // for sched_setaffinity() and the CPU_* macros
+# include <sched.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "sorting_methods.h"
+
+#define MIN_ITEMS_PER_THREAD  (1 << 16) // use fewer threads for small arrays
+#define BUCKETS_PER_THREAD           8 // desired number of buckets per thread
+#define MAX_BUCKETS               2048 // (this must fit in an unsigned short)
+#define OVERSAMPLING                16 // sample size per bucket
+#define LINE_ITEMS                  16 // size of the per-bucket local buffers (one 64-byte cache line)
+#define PAGE_SIZE                 4096
+
+typedef struct
+{
+  T *data;                      // data to be sorted (data[0] is the first item)
+  T *buffer;                    // buffer with room for n items
+  unsigned short *oracle;       // bucket of each item
+  int n;                        // number of items
+  int p;                        // number of threads
+  int n_buckets;                // number of buckets (B)
+  int log2_n_buckets;
+  T tree[MAX_BUCKETS];          // splitters (tree[1..B-1])
+  int *count;                   // count[t*B+b]: number of items of the bucket b in the chunk of thread t (phase 2),
+                                //   and then their position in the buffer (phases 3 and 4)
+  int bucket_start[MAX_BUCKETS + 1];
+  int first_bucket[MAX_SORT_THREADS + 1]; // thread t sorts the buckets first_bucket[t]..first_bucket[t+1]-1
+  pthread_barrier_t barrier;    // all threads wait here at the end of each phase
+}
+pss_t;
+
+typedef struct
+{
+  pss_t *s;
+  int id;                       // thread number
+}
+pss_thread_t;
+
+//
+// position (index) of the first item of chunk c
+//
+static int chunk_start(int n,int p,int c)
+{
+  return (int)((long long)c * (long long)n / (long long)p);
+}
+
+//
+// place the sorted splitters s[0..B-2] in the tree (in-order traversal)
+//
+static void build_tree(T *tree,int j,int n_buckets,T *splitters,int *k)
+{
+  if(j >= n_buckets)
+    return;
+  build_tree(tree,2 * j,n_buckets,splitters,k);
+  tree[j] = splitters[(*k)++];
+  build_tree(tree,2 * j + 1,n_buckets,splitters,k);
+}
+
+//
+// pin the calling thread to the t-th processor of the set of processors the process may use
+//
+static void pin_thread(int t)
+{
+#if defined(__linux__)
+  cpu_set_t allowed,one;
+  int cpu,k;
+
+  if(sched_getaffinity(0,sizeof(allowed),&allowed) != 0 || (k = CPU_COUNT(&allowed)) <= 0)
+    return;
+  for(t %= k,cpu = 0;cpu < CPU_SETSIZE;cpu++)
+    if(CPU_ISSET(cpu,&allowed) && t-- == 0)
+    {
+      CPU_ZERO(&one);
+      CPU_SET(cpu,&one);
+      (void)sched_setaffinity(0,sizeof(one),&one);
+      return;
+    }
+#else
+  (void)t;
+#endif
+}
+
+static void *pss_thread(void *arg)
+{
+  pss_thread_t *th = (pss_thread_t *)arg;
+  pss_t *s = th->s;
+  int i,j,l,b,t,lo,hi,n_buckets,log2_n_buckets,*count,fill[MAX_BUCKETS];
+  T *tree,*line;
+  char *page;
+
+  pin_thread(th->id);
+  n_buckets = s->n_buckets;
+  log2_n_buckets = s->log2_n_buckets;
+  tree = s->tree;
+  lo = chunk_start(s->n,s->p,th->id);
+  hi = chunk_start(s->n,s->p,th->id + 1);
+  count = &s->count[th->id * n_buckets];
+  //
+  // phase 2: classify (four items at a time, so that the four searches overlap)
+  //
+  memset(count,0,(size_t)n_buckets * sizeof(int));
+# define STEP(j,x)  j = 2 * j + (tree[j] < (x))
+  for(i = lo;i + 4 <= hi;i += 4)
+  {
+    int j0 = 1,j1 = 1,j2 = 1,j3 = 1;
+
+    for(l = 0;l < log2_n_buckets;l++)
+    {
+      STEP(j0,s->data[i]);
+      STEP(j1,s->data[i + 1]);
+      STEP(j2,s->data[i + 2]);
+      STEP(j3,s->data[i + 3]);
+    }
+    count[s->oracle[i] = (unsigned short)(j0 - n_buckets)]++;
+    count[s->oracle[i + 1] = (unsigned short)(j1 - n_buckets)]++;
+    count[s->oracle[i + 2] = (unsigned short)(j2 - n_buckets)]++;
+    count[s->oracle[i + 3] = (unsigned short)(j3 - n_buckets)]++;
+  }
+  for(;i < hi;i++)
+  {
+    for(j = 1,l = 0;l < log2_n_buckets;l++)
+      STEP(j,s->data[i]);
+    count[s->oracle[i] = (unsigned short)(j - n_buckets)]++;
+  }
+# undef STEP
+  pthread_barrier_wait(&s->barrier);
+  //
+  // phase 3: positions of the items of each bucket of each thread, and the buckets of each thread
+  //
+  if(th->id == 0)
+  {
+    for(b = j = 0;b < n_buckets;b++)
+    {
+      s->bucket_start[b] = j;
+      for(t = 0;t < s->p;t++)
+      {
+        i = s->count[t * n_buckets + b];
+        s->count[t * n_buckets + b] = j;
+        j += i;
+      }
+    }
+    s->bucket_start[n_buckets] = j;
+    for(t = b = 0;t <= s->p;t++)
+    { // the buckets that start in the t-th chunk
+      while(b < n_buckets && s->bucket_start[b] < chunk_start(s->n,s->p,t))
+        b++;
+      s->first_bucket[t] = (t == s->p) ? n_buckets : b;
+    }
+  }
+  pthread_barrier_wait(&s->barrier);
+  //
+  // phase 4: first touch of this thread's part of the buffer, and then scatter through the local buffers
+  //
+  for(page = (char *)&s->buffer[s->bucket_start[s->first_bucket[th->id]]];
+      page < (char *)&s->buffer[s->bucket_start[s->first_bucket[th->id + 1]]];page += PAGE_SIZE)
+    *page = 0;
+  line = (T *)malloc((size_t)n_buckets * LINE_ITEMS * sizeof(T));
+  pthread_barrier_wait(&s->barrier);
+  if(line == NULL)
+  { // no local buffers, write directly
+    for(i = lo;i < hi;i++)
+      s->buffer[count[s->oracle[i]]++] = s->data[i];
+  }
+  else
+  {
+    memset(fill,0,(size_t)n_buckets * sizeof(int));
+    for(i = lo;i < hi;i++)
+    {
+      b = s->oracle[i];
+      line[b * LINE_ITEMS + fill[b]] = s->data[i];
+      if(++fill[b] == LINE_ITEMS)
+      {
+        memcpy(&s->buffer[count[b]],&line[b * LINE_ITEMS],LINE_ITEMS * sizeof(T));
+        count[b] += LINE_ITEMS;
+        fill[b] = 0;
+      }
+    }
+    for(b = 0;b < n_buckets;b++)
+      memcpy(&s->buffer[count[b]],&line[b * LINE_ITEMS],(size_t)fill[b] * sizeof(T));
+    free(line);
+  }
+  pthread_barrier_wait(&s->barrier);
+  //
+  // phase 5: sort this thread's buckets, and copy them back
+  //
+  for(b = s->first_bucket[th->id];b < s->first_bucket[th->id + 1];b++)
+    radix_sort(s->buffer,s->bucket_start[b],s->bucket_start[b + 1]);
+  i = s->bucket_start[s->first_bucket[th->id]];
+  j = s->bucket_start[s->first_bucket[th->id + 1]];
+  memcpy(s->data + i,s->buffer + i,(size_t)(j - i) * sizeof(T));
+  return NULL;
+}
+
+void parallel_sample_sort(T *data,int first,int one_after_last)
+{
+  pss_thread_t threads[MAX_SORT_THREADS];
+  pthread_t thread_ids[MAX_SORT_THREADS];
+  T splitters[MAX_BUCKETS],*sample = NULL;
+  int i,k,n,p,n_samples;
+  uint64_t r;
+  pss_t *s;
+#if defined(__linux__)
+  cpu_set_t saved_affinity;
+  int restore_affinity;
+#endif
+
+  n = one_after_last - first;
+  p = sort_threads();
+  if(p > n / MIN_ITEMS_PER_THREAD)
+    p = n / MIN_ITEMS_PER_THREAD;
+  if(p <= 1)
+  { // not worth it
+    radix_sort(data,first,one_after_last);
+    return;
+  }
+  s = (pss_t *)malloc(sizeof(pss_t));
+  if(s != NULL)
+  {
+    s->buffer = (T *)malloc((size_t)n * sizeof(T)); // a large block, so its pages are not touched yet
+    s->oracle = (unsigned short *)malloc((size_t)n * sizeof(unsigned short));
+    for(s->n_buckets = 2,s->log2_n_buckets = 1;s->n_buckets < BUCKETS_PER_THREAD * p && s->n_buckets < MAX_BUCKETS;s->n_buckets *= 2)
+      s->log2_n_buckets++;
+    s->count = (int *)malloc((size_t)p * (size_t)s->n_buckets * sizeof(int));
+    n_samples = OVERSAMPLING * s->n_buckets;
+    sample = (T *)malloc((size_t)n_samples * sizeof(T));
+  }
+  if(s == NULL || s->buffer == NULL || s->oracle == NULL || s->count == NULL || sample == NULL)
+  { // not enough memory
+    if(s != NULL)
+    {
+      free(s->buffer);
+      free(s->oracle);
+      free(s->count);
+      free(sample);
+      free(s);
+    }
+    radix_sort(data,first,one_after_last);
+    return;
+  }
+  //
+  // phase 1: splitters (from a pseudo-random sample)
+  //
+  for(i = 0,r = 0x9E3779B97F4A7C15ull;i < n_samples;i++)
+  {
+    r = r * 6364136223846793005ull + 1442695040888963407ull;
+    sample[i] = data[first + (int)((r >> 33) % (uint64_t)n)];
+  }
+  intro_sort(sample,0,n_samples);
+  for(i = 1;i < s->n_buckets;i++)
+    splitters[i - 1] = sample[i * OVERSAMPLING - 1];
+  free(sample);
+  k = 0;
+  build_tree(s->tree,1,s->n_buckets,splitters,&k);
+  //
+  // phases 2 to 5
+  //
+  s->data = data + first;
+  s->n = n;
+  s->p = p;
+  pthread_barrier_init(&s->barrier,NULL,(unsigned int)p);
+  for(i = 0;i < p;i++)
+  {
+    threads[i].s = s;
+    threads[i].id = i;
+  }
+#if defined(__linux__)
+  restore_affinity = (sched_getaffinity(0,sizeof(saved_affinity),&saved_affinity) == 0);
+#endif
+  for(i = 1;i < p;i++)
+    if(pthread_create(&thread_ids[i],NULL,pss_thread,(void *)&threads[i]) != 0)
+    {
+      fprintf(stderr,"parallel_sample_sort: unable to create thread --- 😒\n");
+      exit(1);
+    }
+  (void)pss_thread((void *)&threads[0]); // the calling thread is thread 0
+  for(i = 1;i < p;i++)
+    pthread_join(thread_ids[i],NULL);
+#if defined(__linux__)
+  if(restore_affinity != 0)
+    (void)sched_setaffinity(0,sizeof(saved_affinity),&saved_affinity);
+#endif
+  pthread_barrier_destroy(&s->barrier);
+  free(s->count);
+  free(s->oracle);
+  free(s->buffer);
+  free(s);
+}
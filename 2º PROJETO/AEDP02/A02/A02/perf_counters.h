@@ -0,0 +1,145 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// hardware performance counters (GNU/Linux only, via the perf_event_open system call)
+//
+// use as follows:
+//
+//   double counts[N_PERF_COUNTERS];
+//   if(perf_counters_open() == 0) ... no counters available (they are not supported, or are not permitted) ...
+//   perf_counters_start();
+//   // put your code to be measured here
+//   perf_counters_stop(counts);
+//   perf_counters_close();
+//
+// Each counter is opened on its own, so that a counter that is not available does not prevent the use of the others
+// (perf_counter_available[c] says which ones are available; for the others counts[c] is set to -1). Only user space
+// events of the calling thread and of the threads it creates are counted. If there are more counters than hardware
+// registers the kernel multiplexes them, and the counts are scaled accordingly (so they are estimates).
+//
+// The counters are usually not permitted when /proc/sys/kernel/perf_event_paranoid is larger than 2, and they are
+// usually not available inside containers and virtual machines.
+//
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#define N_PERF_COUNTERS  6
+
+static char *perf_counter_names[N_PERF_COUNTERS] = { "cycles","instructions","branch-misses","L1D-misses","LLC-misses","dTLB-misses" };
+static int perf_counter_available[N_PERF_COUNTERS];
+
+
+#if defined(__linux__)
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static int perf_counter_fds[N_PERF_COUNTERS] = { -1,-1,-1,-1,-1,-1 };
+
+static int perf_counters_open(void)
+{
+# define CACHE_MISSES(cache)  (PERF_COUNT_HW_CACHE_ ## cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+  static const uint32_t types[N_PERF_COUNTERS] =
+  {
+    PERF_TYPE_HARDWARE,PERF_TYPE_HARDWARE,PERF_TYPE_HARDWARE,PERF_TYPE_HW_CACHE,PERF_TYPE_HW_CACHE,PERF_TYPE_HW_CACHE
+  };
+  static const uint64_t configs[N_PERF_COUNTERS] =
+  {
+    PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,PERF_COUNT_HW_BRANCH_MISSES,CACHE_MISSES(L1D),CACHE_MISSES(LL),CACHE_MISSES(DTLB)
+  };
+  struct perf_event_attr attr;
+  int c,n_available;
+
+  for(c = n_available = 0;c < N_PERF_COUNTERS;c++)
+  {
+    memset(&attr,0,sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = types[c];
+    attr.config = configs[c];
+    attr.disabled = 1;
+    attr.inherit = 1;        // count the threads created by the measured code (the parallel sorting routines)
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    perf_counter_fds[c] = (int)syscall(SYS_perf_event_open,&attr,0,-1,-1,0); // this thread, any cpu, no group
+    perf_counter_available[c] = (perf_counter_fds[c] >= 0);
+    n_available += perf_counter_available[c];
+  }
+  return n_available;
+# undef CACHE_MISSES
+}
+
+static void perf_counters_start(void)
+{
+  int c;
+
+  for(c = 0;c < N_PERF_COUNTERS;c++)
+    if(perf_counter_available[c] != 0)
+    {
+      ioctl(perf_counter_fds[c],PERF_EVENT_IOC_RESET,0);
+      ioctl(perf_counter_fds[c],PERF_EVENT_IOC_ENABLE,0);
+    }
+}
+
+static void perf_counters_stop(double *counts)
+{
+  uint64_t v[3]; // value, time enabled, time running
+  int c;
+
+  for(c = 0;c < N_PERF_COUNTERS;c++)
+    if(perf_counter_available[c] != 0)
+      ioctl(perf_counter_fds[c],PERF_EVENT_IOC_DISABLE,0);
+  for(c = 0;c < N_PERF_COUNTERS;c++)
+    if(perf_counter_available[c] == 0 || read(perf_counter_fds[c],v,sizeof(v)) != (ssize_t)sizeof(v))
+      counts[c] = -1.0;
+    else
+      counts[c] = (v[2] == 0 || v[2] >= v[1]) ? (double)v[0] : (double)v[0] * (double)v[1] / (double)v[2];
+}
+
+static void perf_counters_close(void)
+{
+  int c;
+
+  for(c = 0;c < N_PERF_COUNTERS;c++)
+    if(perf_counter_fds[c] >= 0)
+    {
+      close(perf_counter_fds[c]);
+      perf_counter_fds[c] = -1;
+    }
+}
+
+#else
+
+//
+// no hardware performance counters
+//
+
+static int perf_counters_open(void)
+{
+  return 0;
+}
+
+static void perf_counters_start(void)
+{
+}
+
+static void perf_counters_stop(double *counts)
+{
+  int c;
+
+  for(c = 0;c < N_PERF_COUNTERS;c++)
+    counts[c] = -1.0;
+}
+
+static void perf_counters_close(void)
+{
+}
+
+#endif
+
+#endif
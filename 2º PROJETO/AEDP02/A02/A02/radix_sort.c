@@ -0,0 +1,18 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+
+#include "sorting_methods.h"
+
+#define GT                 T
+#define GT_SUFFIX          int
+#define GT_LESS(a,b)       ((a) < (b))
+#define GT_RADIX_KEY(a)    ((uint32_t)(a) ^ 0x80000000u) // flip the sign bit (T is a 32-bit int)
+#define GT_RADIX_KEY_BITS  32
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+
+void radix_sort(T *data,int first,int one_after_last)
+{
+  radix_sort_int(data,first,one_after_last);
+}
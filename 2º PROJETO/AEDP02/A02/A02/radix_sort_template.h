@@ -0,0 +1,183 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// type-generic least significant digit (LSD) radix sort
+//
+// Like sorting_methods_template.h, this file is a "template"; it has to be included after that file, with the same
+// GT and GT_SUFFIX, and it also needs
+//
+//   GT_RADIX_KEY(a)    the key of the item a, mapped to an unsigned integer with the same order as the items
+//                      (for signed integers this is done by flipping the sign bit, for floating point numbers see
+//                      float_radix_key() in sorting_methods.h)
+//   GT_RADIX_KEY_BITS  the number of bits of the mapped key (32 or 64)
+//
+// The indices, and the digit counts, have type GT_INDEX (see sorting_methods_template.h).
+//
+// The keys are sorted 11 bits at a time. One pass over the data counts the digits of all digit positions, the
+// digit positions where all items have the same digit are skipped, and the items go back and forth between the
+// data array and a single buffer (one copy at the end if the number of performed passes is odd).
+//
+// Small arrays, and arrays for which there is no memory for the buffer, are sorted by comparing the mapped keys, not
+// with GT_LESS, so that the order is always the same (for floating point numbers a < b does not order -0.0 and +0.0,
+// and is not even a strict weak order when there are NaNs). These sorts (insertion sort, and key_merge_sort(), which
+// merges without a buffer) are stable, like the radix sort itself.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+static inline void GT_NAME(key_merge)(GT *data,GT_INDEX first,GT_INDEX middle,GT_INDEX one_after_last)
+{ // stable merge of data[first..middle-1] and data[middle..one_after_last-1] without a buffer, comparing the mapped
+  // keys: split the longer run in half, find where its middle item goes in the other run (binary search), swap the
+  // two pieces in between (rotation by three reversals), and merge the two halves recursively; O(n log n) time
+# define KEY_LESS(a,b)  (GT_RADIX_KEY(a) < GT_RADIX_KEY(b))
+  GT_INDEX cut1,cut2,lo,hi,mid,i,j;
+  GT tmp;
+
+  if(first == middle || middle == one_after_last)
+    return;
+  if(one_after_last - first == 2)
+  {
+    if(KEY_LESS(data[middle],data[first]))
+    {
+      tmp = data[first];
+      data[first] = data[middle];
+      data[middle] = tmp;
+    }
+    return;
+  }
+  if(middle - first > one_after_last - middle)
+  { // cut2 is the first item of the second run not smaller than data[cut1] (lower bound)
+    cut1 = first + (middle - first) / 2;
+    for(lo = middle,hi = one_after_last;lo < hi;)
+    {
+      mid = lo + (hi - lo) / 2;
+      if(KEY_LESS(data[mid],data[cut1]))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    cut2 = lo;
+  }
+  else
+  { // cut1 is the first item of the first run larger than data[cut2] (upper bound)
+    cut2 = middle + (one_after_last - middle) / 2;
+    for(lo = first,hi = middle;lo < hi;)
+    {
+      mid = lo + (hi - lo) / 2;
+      if(KEY_LESS(data[cut2],data[mid]))
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+    cut1 = lo;
+  }
+  for(i = cut1,j = middle;i + 1 < j;i++,j--) // rotate data[cut1..cut2-1] so that data[middle] becomes data[cut1]
+  {
+    tmp = data[i];
+    data[i] = data[j - 1];
+    data[j - 1] = tmp;
+  }
+  for(i = middle,j = cut2;i + 1 < j;i++,j--)
+  {
+    tmp = data[i];
+    data[i] = data[j - 1];
+    data[j - 1] = tmp;
+  }
+  for(i = cut1,j = cut2;i + 1 < j;i++,j--)
+  {
+    tmp = data[i];
+    data[i] = data[j - 1];
+    data[j - 1] = tmp;
+  }
+  mid = cut1 + (cut2 - middle);
+  GT_NAME(key_merge)(data,first,cut1,mid);
+  GT_NAME(key_merge)(data,mid,cut2,one_after_last);
+# undef KEY_LESS
+}
+
+static inline void GT_NAME(key_merge_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{ // stable in-place sort, comparing the mapped keys: insertion sort of runs of 16 items, followed by bottom-up merges
+  // (without a buffer, see key_merge()); O(n log^2 n) time
+# define RUN_SIZE  16
+  GT_INDEX i,j,k,width;
+  GT tmp;
+
+  for(k = first;k < one_after_last;k += RUN_SIZE)
+    for(i = k + 1;i < one_after_last && i < k + RUN_SIZE;i++)
+    {
+      tmp = data[i];
+      for(j = i;j > k && GT_RADIX_KEY(tmp) < GT_RADIX_KEY(data[j - 1]);j--)
+        data[j] = data[j - 1];
+      data[j] = tmp;
+    }
+  for(width = RUN_SIZE;width < one_after_last - first;width *= 2)
+    for(k = first;one_after_last - k > width;k += 2 * width)
+      GT_NAME(key_merge)(data,k,k + width,(one_after_last - k - width > width) ? k + 2 * width : one_after_last);
+# undef RUN_SIZE
+}
+
+static inline void GT_NAME(radix_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+# define RADIX_BITS  11
+# define RADIX_SIZE  (1 << RADIX_BITS)
+# define N_DIGITS    ((GT_RADIX_KEY_BITS + RADIX_BITS - 1) / RADIX_BITS)
+# define DIGIT(a,d)  (int)((uint64_t)GT_RADIX_KEY(a) >> ((d) * RADIX_BITS) & (uint64_t)(RADIX_SIZE - 1))
+  GT_INDEX count[N_DIGITS][RADIX_SIZE],sum,c,i,j,n;
+  GT *buffer,*src,*dst,*tmp,item;
+  int d;
+
+  n = one_after_last - first;
+  if(n < 100)
+  { // too small, not worth it; insertion sort, comparing the keys
+    for(i = first + 1;i < one_after_last;i++)
+    {
+      item = data[i];
+      for(j = i;j > first && GT_RADIX_KEY(item) < GT_RADIX_KEY(data[j - 1]);j--)
+        data[j] = data[j - 1];
+      data[j] = item;
+    }
+    return;
+  }
+  buffer = (GT *)malloc((size_t)n * sizeof(GT));
+  if(buffer == NULL)
+  { // not enough memory for the buffer, use an in-place stable sort, comparing the keys
+    GT_NAME(key_merge_sort)(data,first,one_after_last);
+    return;
+  }
+  //
+  // count the digits (all digit positions in a single pass)
+  //
+  src = data + first;
+  memset(count,0,sizeof(count));
+  for(i = 0;i < n;i++)
+    for(d = 0;d < N_DIGITS;d++)
+      count[d][DIGIT(src[i],d)]++;
+  //
+  // one stable counting sort pass per digit position
+  //
+  dst = buffer;
+  for(d = 0;d < N_DIGITS;d++)
+  {
+    if(count[d][DIGIT(src[0],d)] == n)
+      continue; // all items have the same digit, nothing to do
+    for(i = 0,sum = 0;i < (GT_INDEX)RADIX_SIZE;i++)
+    { // count[d][i] becomes the index of the first item with digit i
+      c = count[d][i];
+      count[d][i] = sum;
+      sum += c;
+    }
+    for(i = 0;i < n;i++)
+      dst[count[d][DIGIT(src[i],d)]++] = src[i];
+    tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+  if(src != data + first)
+    memcpy(data + first,src,(size_t)n * sizeof(GT));
+  free(buffer);
+# undef RADIX_BITS
+# undef RADIX_SIZE
+# undef N_DIGITS
+# undef DIGIT
+}
@@ -0,0 +1,288 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// sorting networks for small arrays (AVX2 bitonic sort of 8, 16, 32, or 64 ints), a merge of two sorted arrays that
+// uses a bitonic merging network, and quick sort and merge sort variants that use them
+//
+// small_sort() sorts up to 64 items. On processors with AVX2 the items are loaded (masked load, the missing items are
+// replaced by INT_MAX) into 1, 2, 4, or 8 registers of 8 ints, which are sorted by a bitonic sorting network using
+// min/max instructions and permutations; the first n items are then stored back (masked store). The choice between
+// the AVX2 code and the scalar code (insertion sort) is made at run time, the first time small_sort() or merge_simd()
+// is called (through pthread_once(), because the parallel sorting routines may call them from several threads at once).
+//
+// merge_simd() merges two sorted arrays 8 items at a time (S. Inoue et al., 2007, and J. Chhugani et al., 2008). A
+// register holds the 8 largest items seen so far; the next block of 8 items is loaded from the input whose next item
+// is smaller (a conditional move, not a branch), the two registers are merged by a bitonic merging network of 16
+// items, the 8 smallest items are stored, and the 8 largest ones are kept. The scalar merge that finishes the job (and
+// that is used when AVX2 is not available) does not branch on the comparison either: the comparison result is used to
+// choose the item and to advance the indices. The inner loop of merge_sort() has a branch that is mispredicted about
+// half of the time when the data is random, so merge_simd() is several times faster than it.
+//
+
+#include <limits.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "sorting_methods.h"
+
+#define SMALL_SORT_LIMIT  64
+
+//
+// branchless merge of a[0..m-1] and b[0..l-1] into out[0..m+l-1] (stable)
+//
+static void merge_scalar(T *a,int m,T *b,int l,T *out)
+{
+  int i,j,k,take_b;
+
+  for(i = j = k = 0;i < m && j < l;k++)
+  {
+    take_b = (b[j] < a[i]);
+    out[k] = take_b ? b[j] : a[i];
+    i += 1 - take_b;
+    j += take_b;
+  }
+  while(i < m)
+    out[k++] = a[i++];
+  while(j < l)
+    out[k++] = b[j++];
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+
+#include <immintrin.h>
+
+#define AVX2  __attribute__((target("avx2")))
+
+//
+// compare-exchange of the items of a register that are d = 4, 2, or 1 positions apart; mask (an 8-bit constant) has
+// the bits of the positions that receive the maximum
+//
+#define CMP_SWAP_4(v,mask)  do { __m256i p_ = _mm256_permute2x128_si256(v,v,1);                                        \
+                                 v = _mm256_blend_epi32(_mm256_min_epi32(v,p_),_mm256_max_epi32(v,p_),mask); } while(0)
+#define CMP_SWAP_2(v,mask)  do { __m256i p_ = _mm256_shuffle_epi32(v,_MM_SHUFFLE(1,0,3,2));                            \
+                                 v = _mm256_blend_epi32(_mm256_min_epi32(v,p_),_mm256_max_epi32(v,p_),mask); } while(0)
+#define CMP_SWAP_1(v,mask)  do { __m256i p_ = _mm256_shuffle_epi32(v,_MM_SHUFFLE(2,3,0,1));                            \
+                                 v = _mm256_blend_epi32(_mm256_min_epi32(v,p_),_mm256_max_epi32(v,p_),mask); } while(0)
+
+static AVX2 inline __m256i sort_8(__m256i v)
+{ // bitonic sort of the 8 items of a register
+  CMP_SWAP_1(v,0x66);  // pairs: up, down, up, down
+  CMP_SWAP_2(v,0x3C);  // quads: up, down
+  CMP_SWAP_1(v,0x5A);
+  CMP_SWAP_4(v,0xF0);  // all: up
+  CMP_SWAP_2(v,0xCC);
+  CMP_SWAP_1(v,0xAA);
+  return v;
+}
+
+static AVX2 inline __m256i merge_8(__m256i v)
+{ // the 8 items of the register form a bitonic sequence
+  CMP_SWAP_4(v,0xF0);
+  CMP_SWAP_2(v,0xCC);
+  CMP_SWAP_1(v,0xAA);
+  return v;
+}
+
+static AVX2 inline __m256i reverse_8(__m256i v)
+{
+  return _mm256_permutevar8x32_epi32(v,_mm256_setr_epi32(7,6,5,4,3,2,1,0));
+}
+
+static AVX2 void bitonic_sort(__m256i *v,int k)
+{ // sort the 8*k items of v[0..k-1] (k = 1, 2, 4, or 8)
+  int i,j,w,s;
+  __m256i tmp;
+
+  for(i = 0;i < k;i++)
+    v[i] = sort_8(v[i]);
+  for(w = 1;w < k;w *= 2)
+    for(i = 0;i < k;i += 2 * w)
+    {
+      for(j = 0;j < w / 2;j++)
+      { // reverse the second run (v[i+w..i+2w-1]), so that the two runs form a bitonic sequence
+        tmp = v[i + w + j];
+        v[i + w + j] = v[i + 2 * w - 1 - j];
+        v[i + 2 * w - 1 - j] = tmp;
+      }
+      for(j = 0;j < w;j++)
+        v[i + w + j] = reverse_8(v[i + w + j]);
+      for(s = w;s >= 1;s /= 2)
+        for(j = i;j < i + 2 * w;j++)
+          if(((j - i) & s) == 0)
+          { // half cleaner (registers s apart)
+            tmp = _mm256_min_epi32(v[j],v[j + s]);
+            v[j + s] = _mm256_max_epi32(v[j],v[j + s]);
+            v[j] = tmp;
+          }
+      for(j = i;j < i + 2 * w;j++)
+        v[j] = merge_8(v[j]);
+    }
+}
+
+static AVX2 void small_sort_avx2(T *data,int first,int one_after_last)
+{
+  __m256i v[SMALL_SORT_LIMIT / 8],mask,lane;
+  int i,k,n;
+
+  n = one_after_last - first;
+  for(k = 1;8 * k < n;k *= 2)
+    ;
+  lane = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+  for(i = 0;i < k;i++)
+  {
+    mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(n - 8 * i),lane); // lanes with items
+    v[i] = _mm256_blendv_epi8(_mm256_set1_epi32(INT_MAX),_mm256_maskload_epi32(&data[first + 8 * i],mask),mask);
+  }
+  bitonic_sort(v,k);
+  for(i = 0;i < k;i++)
+  {
+    mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(n - 8 * i),lane);
+    _mm256_maskstore_epi32(&data[first + 8 * i],mask,v[i]);
+  }
+}
+
+static AVX2 void merge_avx2(T *a,int m,T *b,int l,T *out)
+{
+  __m256i hi,lo,v;
+  T tail[24],*next;
+  int i,j,k,take_a;
+
+  if(m < 8 || l < 8)
+  {
+    merge_scalar(a,m,b,l,out);
+    return;
+  }
+  //
+  // hi holds the 8 largest items loaded so far; the next block comes from the input with the smaller next item (the
+  // items of hi, and the items stored before them, are not larger than any item that has not been loaded yet)
+  //
+  hi = _mm256_loadu_si256((__m256i *)&a[0]);
+  i = 8;
+  j = 0;
+  k = 0;
+  while(i + 8 <= m && j + 8 <= l)
+  {
+    take_a = (a[i] <= b[j]);
+    next = take_a ? &a[i] : &b[j];
+    i += 8 & -take_a;
+    j += 8 & (take_a - 1);
+    v = reverse_8(_mm256_loadu_si256((__m256i *)next)); // hi and v form a bitonic sequence of 16 items
+    lo = merge_8(_mm256_min_epi32(hi,v));
+    hi = merge_8(_mm256_max_epi32(hi,v));
+    _mm256_storeu_si256((__m256i *)&out[k],lo);
+    k += 8;
+  }
+  //
+  // one input has fewer than 8 items left; merge them with the items of hi, and then the result with the other input
+  //
+  _mm256_storeu_si256((__m256i *)&tail[0],hi);
+  if(i + 8 > m)
+  {
+    merge_scalar(tail,8,&a[i],m - i,&tail[8]);
+    merge_scalar(&tail[8],8 + m - i,&b[j],l - j,&out[k]);
+  }
+  else
+  {
+    merge_scalar(tail,8,&b[j],l - j,&tail[8]);
+    merge_scalar(&tail[8],8 + l - j,&a[i],m - i,&out[k]);
+  }
+}
+
+static void (*small_sort_function(void))(T *data,int first,int one_after_last)
+{
+  return (sizeof(T) == sizeof(int) && __builtin_cpu_supports("avx2")) ? small_sort_avx2 : insertion_sort;
+}
+
+static void (*merge_function(void))(T *a,int m,T *b,int l,T *out)
+{
+  return (sizeof(T) == sizeof(int) && __builtin_cpu_supports("avx2")) ? merge_avx2 : merge_scalar;
+}
+
+#else
+
+static void (*small_sort_function(void))(T *data,int first,int one_after_last)
+{
+  return insertion_sort;
+}
+
+static void (*merge_function(void))(T *a,int m,T *b,int l,T *out)
+{
+  return merge_scalar;
+}
+
+#endif
+
+//
+// run time dispatch (done once, by the first thread that gets here; the others wait for it)
+//
+static pthread_once_t dispatch_once = PTHREAD_ONCE_INIT;
+static void (*small_sort_dispatch)(T *data,int first,int one_after_last);
+static void (*merge_dispatch)(T *a,int m,T *b,int l,T *out);
+
+static void dispatch(void)
+{
+  small_sort_dispatch = small_sort_function();
+  merge_dispatch = merge_function();
+}
+
+//
+// sort up to SMALL_SORT_LIMIT items (larger arrays are sorted by insertion sort)
+//
+void small_sort(T *data,int first,int one_after_last)
+{
+  if(one_after_last - first > SMALL_SORT_LIMIT)
+    insertion_sort(data,first,one_after_last);
+  else
+  {
+    pthread_once(&dispatch_once,dispatch);
+    (*small_sort_dispatch)(data,first,one_after_last);
+  }
+}
+
+//
+// merge a[0..m-1] and b[0..l-1] into out[0..m+l-1] (out must not overlap a or b)
+//
+void merge_simd(T *a,int m,T *b,int l,T *out)
+{
+  pthread_once(&dispatch_once,dispatch);
+  (*merge_dispatch)(a,m,b,l,out);
+}
+
+//
+// quick_sort() with small_sort() for subarrays with up to 64 items
+//
+void quick_sort_simd(T *data,int first,int one_after_last)
+{
+  int first_equal,one_after_equal;
+
+  if(one_after_last - first <= SMALL_SORT_LIMIT)
+    small_sort(data,first,one_after_last);
+  else
+  {
+    quick_sort_partition(data,first,one_after_last,&first_equal,&one_after_equal);
+    quick_sort_simd(data,first,first_equal);
+    quick_sort_simd(data,one_after_equal,one_after_last);
+  }
+}
+
+//
+// merge_sort() with small_sort() for subarrays with up to 64 items, and with merge_simd()
+//
+void merge_sort_simd(T *data,int first,int one_after_last)
+{
+  int i,middle;
+  T *buffer;
+
+  if(one_after_last - first <= SMALL_SORT_LIMIT)
+    small_sort(data,first,one_after_last);
+  else
+  {
+    middle = first + (one_after_last - first) / 2;
+    merge_sort_simd(data,first,middle);
+    merge_sort_simd(data,middle,one_after_last);
+    buffer = (T *)malloc((size_t)(one_after_last - first) * sizeof(T)) - first; // no error check!
+    merge_simd(&data[first],middle - first,&data[middle],one_after_last - middle,&buffer[first]);
+    for(i = first;i < one_after_last;i++)
+      data[i] = buffer[i];
+    free(buffer + first);
+  }
+}
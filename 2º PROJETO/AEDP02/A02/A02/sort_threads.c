@@ -0,0 +1,22 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// number of threads used by the parallel sorting routines
+//
+
+#include <unistd.h>
+#include "sorting_methods.h"
+
+int n_sort_threads = 0; // 0 means one thread per online processor
+
+int sort_threads(void)
+{
+  long n;
+
+  n = (n_sort_threads > 0) ? (long)n_sort_threads : sysconf(_SC_NPROCESSORS_ONLN);
+  if(n < 1L)
+    return 1;
+  if(n > (long)MAX_SORT_THREADS)
+    return MAX_SORT_THREADS;
+  return (int)n;
+}
@@ -9,7 +9,18 @@
 //      This can be done by running the following commands
 //      > make sorting_methods
 //      > ./sorting_methods -measure | tee output.txt
-//      The program will take some time to finish (somewhere between 1 hour and 4 hours)
+//      The program will take some time to finish (a few minutes; each value of n is measured only until the median
+//      time is known with a precision of about 2%)
+//      To test or measure the type-generic sorting routines, give the data type after -test or -measure, as in
+//      > ./sorting_methods -measure int64 | tee output_int64.txt
+//      To compare direct and indirect sorting of large records, give the record size in the data type, as in
+//      > ./sorting_methods -measure record256 | tee output_record256.txt
+//      To measure with other kinds of input data (sorted, reversed, few distinct values, ...), use the -dist option
+//      > ./sorting_methods -measure -dist all | tee output_all.txt
+//      To measure the string sorting routines, with random urls, paths, words, or keys, do
+//      > ./sorting_methods -measure string -strings paths | tee output_string_paths.txt
+//      The crossover table of auto_sort() depends on the machine; to measure it again, and then use it, do
+//      > ./sorting_methods -calibrate > auto_sort_table.h && make sorting_methods
 //   2. (highly recommended)
 //      Read and understand the code of the main function.
 //   2. (mandatory)
@@ -22,30 +33,668 @@
 
 #include <math.h>
 #include <time.h>
+#include <float.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "sorting_methods.h"
 #include "../P02/elapsed_time.h"
+#include "perf_counters.h"
+#include "streaming_quantile.h"
+#include "huge_pages.h"
 
-void show(T *data,int first,int one_after_last)
+//
+// test and measurement code, one instance for each data type (see sorting_methods_harness.h)
+//
+
+static double (*measure_time)(void) = cpu_time; // wall_time with the -wall option (for the parallel sorting routines)
+static input_distribution_t *input_distribution = &input_distributions[0]; // -dist option (NULL means all of them)
+static int use_counters = 0;                    // 1 with the -counters option (hardware performance counters)
+
+// the int sorting routines of sorting_methods.h
+#define GT             T
+#define GT_SUFFIX      int
+#define GT_LESS(a,b)   ((a) < (b))
+#define GT_SET(a,v)    do (a) = (T)(v); while(0)
+#define GT_RANDOM(a)   do (a) = (T)rand(); while(0)
+#define GT_KEY(a)      (double)(a)
+#include "sorting_methods_harness.h"
+
+// 32-bit integers
+#define GT             int32_t
+#define GT_SUFFIX      i32
+#define GT_LESS(a,b)   ((a) < (b))
+#define GT_SET(a,v)    do (a) = (int32_t)(v); while(0)
+#define GT_RANDOM(a)   do (a) = (int32_t)rand(); while(0)
+#define GT_KEY(a)      (double)(a)
+#define GT_RADIX_KEY(a)    ((uint32_t)(a) ^ 0x80000000u)
+#define GT_RADIX_KEY_BITS  32
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "block_merge_sort_template.h"
+#include "tim_sort_template.h"
+#include "sorting_methods_harness.h"
+
+// 64-bit integers (the random keys use all 63 non-sign bits)
+#define GT             int64_t
+#define GT_SUFFIX      i64
+#define GT_LESS(a,b)   ((a) < (b))
+#define GT_SET(a,v)    do (a) = (int64_t)(v); while(0)
+#define GT_RANDOM(a)   do (a) = ((int64_t)rand() << 32) ^ ((int64_t)rand() << 16) ^ (int64_t)rand(); while(0)
+#define GT_KEY(a)      (double)(a)
+#define GT_RADIX_KEY(a)    ((uint64_t)(a) ^ 0x8000000000000000u)
+#define GT_RADIX_KEY_BITS  64
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "block_merge_sort_template.h"
+#include "tim_sort_template.h"
+#include "sorting_methods_harness.h"
+
+// 32-bit and 64-bit integers, with size_t indices (for arrays with 2^31 or more items)
+#define GT             int32_t
+#define GT_SUFFIX      i32z
+#define GT_INDEX       size_t
+#define GT_LESS(a,b)   ((a) < (b))
+#define GT_SET(a,v)    do (a) = (int32_t)(v); while(0)
+#define GT_RANDOM(a)   do (a) = (int32_t)rand(); while(0)
+#define GT_KEY(a)      (double)(a)
+#define GT_RADIX_KEY(a)    ((uint32_t)(a) ^ 0x80000000u)
+#define GT_RADIX_KEY_BITS  32
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "sorting_methods_harness.h"
+
+#define GT             int64_t
+#define GT_SUFFIX      i64z
+#define GT_INDEX       size_t
+#define GT_LESS(a,b)   ((a) < (b))
+#define GT_SET(a,v)    do (a) = (int64_t)(v); while(0)
+#define GT_RANDOM(a)   do (a) = ((int64_t)rand() << 32) ^ ((int64_t)rand() << 16) ^ (int64_t)rand(); while(0)
+#define GT_KEY(a)      (double)(a)
+#define GT_RADIX_KEY(a)    ((uint64_t)(a) ^ 0x8000000000000000u)
+#define GT_RADIX_KEY_BITS  64
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "sorting_methods_harness.h"
+
+// floats and doubles (the random keys are uniformly distributed in [0,1); the radix sort orders -0.0 before +0.0,
+// and places the NaNs at the end, see float_radix_key() and double_radix_key())
+#define GT             float
+#define GT_SUFFIX      f32
+#define GT_LESS(a,b)   ((a) < (b))
+#define GT_SET(a,v)    do (a) = (float)(v); while(0)
+#define GT_RANDOM(a)   do (a) = (float)((double)rand() / ((double)RAND_MAX + 1.0)); while(0)
+#define GT_KEY(a)      (double)(a)
+#define GT_RADIX_KEY(a)    float_radix_key(a)
+#define GT_RADIX_KEY_BITS  32
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "sorting_methods_harness.h"
+
+#define GT             double
+#define GT_SUFFIX      f64
+#define GT_LESS(a,b)   ((a) < (b))
+#define GT_SET(a,v)    do (a) = (double)(v); while(0)
+#define GT_RANDOM(a)   do (a) = (double)rand() / ((double)RAND_MAX + 1.0); while(0)
+#define GT_KEY(a)      (a)
+#define GT_RADIX_KEY(a)    double_radix_key(a)
+#define GT_RADIX_KEY_BITS  64
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "block_merge_sort_template.h"
+#include "tim_sort_template.h"
+#include "sorting_methods_harness.h"
+
+// 16-byte records (64-bit key and 64-bit payload; only the key is compared, and the payload is the tag of the
+// stability test)
+#define GT             record16_t
+#define GT_SUFFIX      r16
+#define GT_LESS(a,b)   ((a).key < (b).key)
+#define GT_SET(a,v)    do { (a).key = (int64_t)(v); (a).payload = (int64_t)(v); } while(0)
+#define GT_RANDOM(a)   do { (a).key = (int64_t)rand(); (a).payload = (a).key; } while(0)
+#define GT_KEY(a)      (double)(a).key
+#define GT_TAG(a)      (a).payload
+#define GT_RADIX_KEY(a)    ((uint64_t)(a).key ^ 0x8000000000000000u)
+#define GT_RADIX_KEY_BITS  64
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "block_merge_sort_template.h"
+#include "tim_sort_template.h"
+#include "sorting_methods_harness.h"
+
+// 64-byte, 128-byte, and 256-byte records (64-bit key, 64-bit tag, and a payload; only the key is compared), sorted
+// directly and indirectly (by sorting (key,index) pairs with the record16_t sorting routines, and then moving each
+// record once); the tag is the GT_TAG of the test, which checks that each record is moved in one piece, and that none
+// is lost or duplicated
+#define GT             record64_t
+#define GT_SUFFIX      r64
+#define GT_LESS(a,b)   ((a).key < (b).key)
+#define GT_SET(a,v)    do { (a).key = (a).tag = (int64_t)(v); memset((a).payload,(int)(v),sizeof((a).payload)); } while(0)
+#define GT_RANDOM(a)   do { (a).key = (a).tag = (int64_t)rand(); memset((a).payload,(int)(a).key,sizeof((a).payload)); } while(0)
+#define GT_KEY(a)      (double)(a).key
+#define GT_TAG(a)      (a).tag
+#define GT_RADIX_KEY(a)     ((uint64_t)(a).key ^ 0x8000000000000000u)
+#define GT_RADIX_KEY_BITS   64
+#define GT_INDIRECT_KEY(a)  (a).key
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "indirect_sort_template.h"
+#include "sorting_methods_harness.h"
+
+#define GT             record128_t
+#define GT_SUFFIX      r128
+#define GT_LESS(a,b)   ((a).key < (b).key)
+#define GT_SET(a,v)    do { (a).key = (a).tag = (int64_t)(v); memset((a).payload,(int)(v),sizeof((a).payload)); } while(0)
+#define GT_RANDOM(a)   do { (a).key = (a).tag = (int64_t)rand(); memset((a).payload,(int)(a).key,sizeof((a).payload)); } while(0)
+#define GT_KEY(a)      (double)(a).key
+#define GT_TAG(a)      (a).tag
+#define GT_RADIX_KEY(a)     ((uint64_t)(a).key ^ 0x8000000000000000u)
+#define GT_RADIX_KEY_BITS   64
+#define GT_INDIRECT_KEY(a)  (a).key
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "indirect_sort_template.h"
+#include "sorting_methods_harness.h"
+
+#define GT             record256_t
+#define GT_SUFFIX      r256
+#define GT_LESS(a,b)   ((a).key < (b).key)
+#define GT_SET(a,v)    do { (a).key = (a).tag = (int64_t)(v); memset((a).payload,(int)(v),sizeof((a).payload)); } while(0)
+#define GT_RANDOM(a)   do { (a).key = (a).tag = (int64_t)rand(); memset((a).payload,(int)(a).key,sizeof((a).payload)); } while(0)
+#define GT_KEY(a)      (double)(a).key
+#define GT_TAG(a)      (a).tag
+#define GT_RADIX_KEY(a)     ((uint64_t)(a).key ^ 0x8000000000000000u)
+#define GT_RADIX_KEY_BITS   64
+#define GT_INDIRECT_KEY(a)  (a).key
+#include "sorting_methods_template.h"
+#include "radix_sort_template.h"
+#include "indirect_sort_template.h"
+#include "sorting_methods_harness.h"
+
+// strings (compared by strcmp(); the strings come from string_generators.c, and GT_KEY, which is only used to tell the
+// -1 filler, an empty string, apart and by show, is the length of the string)
+#define GT             string_t
+#define GT_SUFFIX      str
+#define GT_LESS(a,b)   (strcmp(a,b) < 0)
+#define GT_SET(a,v)    do (a) = string_of_int(v); while(0)
+#define GT_RANDOM(a)   do (a) = random_string(); while(0)
+#define GT_KEY(a)      (((a)[0] == '\0') ? -1.0 : (double)strlen(a))
+#define GT_NEW_DATA()  strings_reset()
+#include "sorting_methods_template.h"
+#include "sorting_methods_harness.h"
+
+#define GENERIC_FUNCTIONS(suffix)                                                    \
+  STABLE(bubble_sort,suffix), STABLE(shaker_sort,suffix), STABLE(insertion_sort,suffix), \
+  EXPAND(Shell_sort,suffix),  EXPAND(quick_sort,suffix),  STABLE(merge_sort,suffix),     \
+  EXPAND(heap_sort,suffix),   STABLE(rank_sort,suffix),   EXPAND(selection_sort,suffix)
+#define EXPAND(name,suffix)  { name ## _ ## suffix,# name "_" # suffix,0 }
+#define STABLE(name,suffix)  { name ## _ ## suffix,# name "_" # suffix,1 }
+#define STABLE_FUNCTIONS(suffix) \
+  STABLE(radix_sort,suffix), STABLE(block_merge_sort,suffix), STABLE(tim_sort,suffix)
+static sort_entry_i32 functions_i32[] = { GENERIC_FUNCTIONS(i32),STABLE_FUNCTIONS(i32) };
+static sort_entry_i64 functions_i64[] = { GENERIC_FUNCTIONS(i64),STABLE_FUNCTIONS(i64) };
+static sort_entry_i32z functions_i32z[] = { GENERIC_FUNCTIONS(i32z),EXPAND(radix_sort,i32z) };
+static sort_entry_i64z functions_i64z[] = { GENERIC_FUNCTIONS(i64z),EXPAND(radix_sort,i64z) };
+static sort_entry_f32 functions_f32[] = { GENERIC_FUNCTIONS(f32),STABLE(radix_sort,f32) };
+static sort_entry_f64 functions_f64[] = { GENERIC_FUNCTIONS(f64),STABLE_FUNCTIONS(f64) };
+static sort_entry_r16 functions_r16[] = { GENERIC_FUNCTIONS(r16),STABLE_FUNCTIONS(r16),STABLE(key_merge_sort,r16) };
+#define RECORD_FUNCTIONS(suffix)                                                                                  \
+  EXPAND(Shell_sort,suffix),          EXPAND(quick_sort,suffix),          EXPAND(merge_sort,suffix),          \
+  EXPAND(heap_sort,suffix),           EXPAND(radix_sort,suffix),                                                \
+  EXPAND(indirect_Shell_sort,suffix), EXPAND(indirect_quick_sort,suffix), EXPAND(indirect_merge_sort,suffix), \
+  EXPAND(indirect_heap_sort,suffix),  EXPAND(indirect_radix_sort,suffix)
+static sort_entry_r64 functions_r64[] = { RECORD_FUNCTIONS(r64) };
+static sort_entry_r128 functions_r128[] = { RECORD_FUNCTIONS(r128) };
+static sort_entry_r256 functions_r256[] = { RECORD_FUNCTIONS(r256) };
+static sort_entry_str functions_str[] =
 {
-  int i;
+  GENERIC_FUNCTIONS(str),
+  { multikey_quick_sort,"multikey_quick_sort",0 },
+  { msd_radix_sort,"msd_radix_sort",0 },
+  { lcp_merge_sort,"lcp_merge_sort",1 }
+};
+#undef RECORD_FUNCTIONS
+#undef STABLE_FUNCTIONS
+#undef STABLE
+#undef EXPAND
+#undef GENERIC_FUNCTIONS
 
-  printf("[%2d,%2d]",first,one_after_last - 1);
-  for(i = first;i < one_after_last;i++)
-    printf(" %5d",data[i]);
-  printf("\n");
+//
+// the selection routines (nth_element.c), tested against a full sort, and written as sorting routines for -measure
+//
+
+static int test_selection(void)
+{
+# define MAX_N   1000  // test array sizes up to this limit
+# define N_TESTS   20  // number of tests to perform for each array size
+  static char *names[3] = { "nth_element","partial_sort","top_k" };
+  static T master[MAX_N],data[MAX_N],sorted[MAX_N],copy[MAX_N];
+  static int values[MAX_N];
+  int d,f,i,j,n,nth,lo,hi,first,one_after_last;
+
+  srand((unsigned int)time(NULL));
+  for(d = 0;d < n_input_distributions;d++)
+    if(input_distribution == NULL || input_distribution == &input_distributions[d])
+      for(n = 1;n <= MAX_N;n++)
+      {
+        if(input_distributions[d].function == NULL)
+          for(i = 0;i < n;i++)
+            master[i] = (T)(rand() % MAX_N);
+        else
+        {
+          (*input_distributions[d].function)(values,n,(unsigned int)rand());
+          for(i = 0;i < n;i++)
+            master[i] = (T)values[i];
+        }
+        first = 0;
+        one_after_last = n;
+        for(j = 0;j < N_TESTS;j++)
+        {
+          fprintf(stderr,"%4d[%4d,%4d] \r",n,first,one_after_last);
+          nth = first + (int)rand() % (one_after_last - first);
+          for(i = 0;i < n;i++)
+            sorted[i] = master[i];
+          merge_sort(sorted,first,one_after_last);
+          for(f = 0;f < 3;f++)
+          {
+            for(i = 0;i < n;i++)
+              data[i] = (i < first || i >= one_after_last) ? -1 : master[i];
+            if(f == 0)
+            { // data[nth] must be in place
+              nth_element(data,first,nth,one_after_last);
+              lo = nth;
+              hi = nth + 1;
+            }
+            else if(f == 1)
+            { // data[first..nth] must be in place
+              partial_sort(data,first,nth + 1,one_after_last);
+              lo = first;
+              hi = nth + 1;
+            }
+            else
+            { // data[nth..one_after_last-1] must be in place
+              top_k(data,first,one_after_last,one_after_last - nth);
+              lo = nth;
+              hi = one_after_last;
+            }
+            for(i = 0;i < n;i++)
+              copy[i] = data[i];
+            merge_sort(copy,first,one_after_last); // same items?
+            for(i = 0;i < n;i++)
+              if((i < first || i >= one_after_last) ? data[i] != -1
+                                                    : (copy[i] != sorted[i] || (i >= lo && i < hi && data[i] != sorted[i]) ||
+                                                       (i < lo && data[i] > sorted[lo]) || (i >= hi && data[i] < sorted[hi - 1])))
+              {
+                fprintf(stderr,"%s() failed for n=%d, first=%d, one_after_last=%d, and nth=%d (error for i=%d, %s input) --- 😒\n",names[f],n,first,one_after_last,nth,i,input_distributions[d].name);
+                exit(1);
+              }
+          }
+          first = (int)rand() % (1 + (3 * n) / 4);
+          do
+            one_after_last = (int)rand() % (1 + n);
+          while(one_after_last <= first);
+        }
+      }
+  printf("No errors found in the selection routines --- 😀\n");
+  return 0;
+# undef MAX_N
+# undef N_TESTS
 }
 
-int main(int argc,char *argv[argc])
+//
+// the parallel sorting routines, tested with arrays large enough to reach their parallel code (the partitions of a
+// team of threads, the work-stealing deques, the merge-path merges, the buckets of the sample sort), with 2 to 8
+// threads; the result is compared with that of radix_sort(), and the items outside [first,one_after_last) must not
+// be touched
+//
+
+static int test_parallel(sort_entry_int *functions,int n_functions)
+{
+# define GUARD      1000   // items before first and after one_after_last
+# define MIN_N     50000   // test array sizes from this limit ...
+# define MAX_N   1500000   // ... up to this limit (more than MIN_ITEMS_PER_THREAD items for each of 8 threads)
+# define N_TESTS       3   // number of array sizes
+  static int n_threads[] = { 2,3,4,8 };
+  int d,f,i,j,t,n,first,one_after_last,saved_n_sort_threads,*values;
+  T *master,*data,*sorted;
+
+  values = (int *)malloc((size_t)MAX_N * sizeof(int));
+  master = (T *)malloc((size_t)(MAX_N + 2 * GUARD) * sizeof(T));
+  data = (T *)malloc((size_t)(MAX_N + 2 * GUARD) * sizeof(T));
+  sorted = (T *)malloc((size_t)(MAX_N + 2 * GUARD) * sizeof(T));
+  if(values == NULL || master == NULL || data == NULL || sorted == NULL)
+  {
+    fprintf(stderr,"unable to allocate memory for the test of the parallel sorting routines --- 😒\n");
+    exit(1);
+  }
+  saved_n_sort_threads = n_sort_threads;
+  srand((unsigned int)time(NULL));
+  for(d = 0;d < n_input_distributions;d++)
+    if(input_distribution == NULL || input_distribution == &input_distributions[d])
+      for(j = 0;j < N_TESTS;j++)
+      {
+        n = MIN_N + (int)((long long)j * (MAX_N - MIN_N) / (N_TESTS - 1)) - (int)rand() % 1000; // n is not a "nice" number
+        if(input_distributions[d].max_n > 0 && n > input_distributions[d].max_n)
+          n = input_distributions[d].max_n;
+        first = GUARD - (int)rand() % GUARD; // [first,one_after_last) does not begin at the start of the array
+        one_after_last = first + n;
+        if(input_distributions[d].function == NULL)
+          for(i = 0;i < n;i++)
+            values[i] = (int)rand();
+        else
+          (*input_distributions[d].function)(values,n,(unsigned int)rand());
+        for(i = 0;i < one_after_last + GUARD;i++)
+          master[i] = (i < first || i >= one_after_last) ? -1 : (T)values[i - first];
+        for(i = 0;i < one_after_last + GUARD;i++)
+          sorted[i] = master[i];
+        radix_sort(sorted,first,one_after_last);
+        for(t = 0;t < (int)(sizeof(n_threads) / sizeof(n_threads[0]));t++)
+        {
+          n_sort_threads = n_threads[t];
+          for(f = 0;f < n_functions;f++)
+          {
+            fprintf(stderr,"%7d %d \r",n,n_threads[t]);
+            for(i = 0;i < one_after_last + GUARD;i++)
+              data[i] = master[i];
+            (*functions[f].function)(data,first,one_after_last);
+            for(i = 0;i < one_after_last + GUARD;i++)
+              if(data[i] != sorted[i])
+              {
+                fprintf(stderr,"%s() failed for n=%d, first=%d, and %d threads (%s error for i=%d, %s input) --- 😒\n",functions[f].name,n,first,n_threads[t],(i < first || i >= one_after_last) ? "access" : "sort",i,input_distributions[d].name);
+                exit(1);
+              }
+          }
+        }
+      }
+  n_sort_threads = saved_n_sort_threads;
+  free(sorted);
+  free(data);
+  free(master);
+  free(values);
+  printf("No errors found in the parallel sorting routines --- 😀\n");
+  return 0;
+# undef GUARD
+# undef MIN_N
+# undef MAX_N
+# undef N_TESTS
+}
+
+//
+// the radix sort of floats and doubles, tested against a comparison sort, qsort(), with the order of the keys of
+// float_radix_key() and double_radix_key(); the data includes the numbers that a < b does not order (-0.0 and +0.0,
+// and NaNs of both signs, with random payloads), infinities, subnormal numbers, and duplicates; since two numbers have
+// the same key only if they have the same bits, the sorted arrays must be equal bit by bit; the heap sort used by the
+// radix sort when there is no memory for its buffer is also tested (directly)
+//
+
+static int compare_f32_keys(const void *a,const void *b)
+{
+  uint32_t key_a = float_radix_key(*(const float *)a),key_b = float_radix_key(*(const float *)b);
+
+  return (key_a > key_b) - (key_a < key_b);
+}
+
+static int compare_f64_keys(const void *a,const void *b)
+{
+  uint64_t key_a = double_radix_key(*(const double *)a),key_b = double_radix_key(*(const double *)b);
+
+  return (key_a > key_b) - (key_a < key_b);
+}
+
+static int test_float_radix(void)
+{
+# define MAX_N   1000  // test array sizes up to this limit
+# define N_TESTS   20  // number of tests to perform for each array size
+  static double special[] = { 0.0,-0.0,1.0,-1.0,1.0e-310,-1.0e-310,1.0e-40,-1.0e-40,DBL_MAX,-DBL_MAX,FLT_MAX,-FLT_MAX,INFINITY,-INFINITY,NAN,-NAN };
+  static double data64[MAX_N],sorted64[MAX_N],merged64[MAX_N];
+  static float data32[MAX_N],sorted32[MAX_N],merged32[MAX_N];
+  int i,j,n;
+  uint64_t u;
+
+  srand((unsigned int)time(NULL));
+  for(n = 1;n <= MAX_N;n++)
+    for(j = 0;j < N_TESTS;j++)
+    {
+      fprintf(stderr,"%4d \r",n);
+      for(i = 0;i < n;i++)
+        switch(rand() % 4)
+        {
+          case 0: // a special number
+            data64[i] = special[rand() % (int)(sizeof(special) / sizeof(special[0]))];
+            break;
+          case 1: // a NaN with a random sign and a random payload (that survives the conversion to float)
+            u = ((uint64_t)(rand() & 1) << 63) | 0x7FF0000000000000u | ((uint64_t)(1 + rand() % 4194303) << 29);
+            memcpy(&data64[i],&u,sizeof(u));
+            break;
+          case 2: // a number of random sign and magnitude
+            data64[i] = ldexp((double)rand() - (double)RAND_MAX / 2.0,rand() % 400 - 200);
+            break;
+          default: // a duplicate
+            data64[i] = (i > 0) ? data64[rand() % i] : 0.0;
+            break;
+        }
+      for(i = 0;i < n;i++)
+        data32[i] = (float)data64[i];
+      memcpy(sorted64,data64,(size_t)n * sizeof(double));
+      memcpy(sorted32,data32,(size_t)n * sizeof(float));
+      memcpy(merged64,data64,(size_t)n * sizeof(double));
+      memcpy(merged32,data32,(size_t)n * sizeof(float));
+      qsort(sorted64,(size_t)n,sizeof(double),compare_f64_keys);
+      qsort(sorted32,(size_t)n,sizeof(float),compare_f32_keys);
+      radix_sort_f64(data64,0,n);
+      radix_sort_f32(data32,0,n);
+      key_merge_sort_f64(merged64,0,n);
+      key_merge_sort_f32(merged32,0,n);
+      for(i = 1;i < n;i++) // the defined order: -0.0 before +0.0, and the NaNs at the end
+        if((isnan(data64[i - 1]) && !isnan(data64[i])) || (data64[i - 1] == 0.0 && data64[i] == 0.0 && signbit(data64[i]) && !signbit(data64[i - 1])) ||
+           (isnan(data32[i - 1]) && !isnan(data32[i])) || (data32[i - 1] == 0.0f && data32[i] == 0.0f && signbit(data32[i]) && !signbit(data32[i - 1])))
+        {
+          fprintf(stderr,"radix_sort_f64() or radix_sort_f32() failed for n=%d (misplaced NaN or -0.0 for i=%d) --- 😒\n",n,i);
+          exit(1);
+        }
+      if(memcmp(data64,sorted64,(size_t)n * sizeof(double)) != 0 || memcmp(data32,sorted32,(size_t)n * sizeof(float)) != 0)
+      {
+        fprintf(stderr,"radix_sort_%s() failed for n=%d (order of -0.0, +0.0, NaN, ...) --- 😒\n",(memcmp(data64,sorted64,(size_t)n * sizeof(double)) != 0) ? "f64" : "f32",n);
+        exit(1);
+      }
+      if(memcmp(merged64,sorted64,(size_t)n * sizeof(double)) != 0 || memcmp(merged32,sorted32,(size_t)n * sizeof(float)) != 0)
+      {
+        fprintf(stderr,"key_merge_sort_%s() failed for n=%d (order of -0.0, +0.0, NaN, ...) --- 😒\n",(memcmp(merged64,sorted64,(size_t)n * sizeof(double)) != 0) ? "f64" : "f32",n);
+        exit(1);
+      }
+    }
+  printf("No errors found in the floating point radix sorts --- 😀\n");
+  return 0;
+# undef MAX_N
+# undef N_TESTS
+}
+
+static void nth_element_median(T *data,int first,int one_after_last)
 {
+  nth_element(data,first,first + (one_after_last - first) / 2,one_after_last);
+}
+
+static void partial_sort_100(T *data,int first,int one_after_last)
+{
+  partial_sort(data,first,first + 100,one_after_last);
+}
+
+static void top_k_10(T *data,int first,int one_after_last)
+{
+  top_k(data,first,one_after_last,10);
+}
+
+static void top_k_1000(T *data,int first,int one_after_last)
+{
+  top_k(data,first,one_after_last,1000);
+}
+
+//
+// the crossover table of auto_sort() (auto_sort.c), written to stdout in the format of auto_sort_table.h
+//
+// For each shape, the candidate sorting routines sort the same data (from the input distribution of that shape) for
+// n = 10^(k/4); each time is the best of N_BATCHES batches of at least MIN_ITEMS items (many copies of a small array).
+// Measurement noise must not split the table into many tiny pieces, so
+//   * the previous routine is kept while it is within HYSTERESIS of the fastest one
+//   * otherwise, the first routine of the list (it is in order of preference) within HYSTERESIS of the fastest one is
+//     the challenger; it takes over only if it is also chosen for the next value of n (a single win is noise)
+//   * with one thread, the parallel routines (parallel_*) are not candidates (they would just call a sequential
+//     routine, which would make two candidates out of the same code)
+// auto_sort_shape() checks the presortedness first, so presorted data with keys of any range is AUTO_SORT_PRESORTED;
+// the keys of its input (0..n-1) are therefore spread over the whole range of an int, keeping their order (otherwise
+// counting_sort() would win with keys that auto_sort() would not give it).
+// The crossover point is placed halfway (geometrically) between the last n of the previous routine and the first n
+// of the challenger. A routine that is GIVE_UP times slower than the fastest one and takes more than GIVE_UP_TIME
+// seconds is not tried for larger n.
+//
+static int calibrate(sort_entry_int *functions,int n_functions)
+{
+# define MAX_K          28  // largest n is 10^(MAX_K/4)
+# define MIN_ITEMS  1000000  // each batch sorts at least this number of items
+# define N_BATCHES        5  // number of batches for each routine and n
+# define HYSTERESIS    1.10  // the previous routine is kept unless another one is at least 10% faster
+# define GIVE_UP        4.0  // see above
+# define GIVE_UP_TIME  0.05  // idem
   static struct
   {
-    sort_function_t function;
-    char *name;
+    int shape;
+    char *shape_name;
+    char *input;         // input distribution used to measure this shape
+    int wide;            // 1 if the keys of the input, 0..n-1, are spread over the whole range of an int
+  }
+  shapes[AUTO_SORT_N_SHAPES] =
+  {
+    { AUTO_SORT_RANDOM,     "AUTO_SORT_RANDOM",     "random",        0 },
+    { AUTO_SORT_PRESORTED,  "AUTO_SORT_PRESORTED",  "nearly_sorted", 1 },
+    { AUTO_SORT_DUPLICATES, "AUTO_SORT_DUPLICATES", "few_unique",    0 },
+    { AUTO_SORT_NARROW,     "AUTO_SORT_NARROW",     "narrow_range",  0 }
+  };
+  int s,f,k,i,b,r,n,reps,prev_n,best,current,challenger,crossover_n,stride,*alive;
+  double t,*times;
+  input_distribution_t *dist;
+  T *master,*data;
+
+  n = (int)round(pow(10.0,0.25 * (double)MAX_K));
+  master = (T *)malloc((size_t)n * sizeof(T));
+  data = (T *)malloc((size_t)n * sizeof(T));
+  times = (double *)malloc((size_t)n_functions * sizeof(double));
+  alive = (int *)malloc((size_t)n_functions * sizeof(int));
+  if(master == NULL || data == NULL || times == NULL || alive == NULL)
+  {
+    fprintf(stderr,"unable to allocate memory for the data array --- 😒\n");
+    exit(1);
+  }
+  printf("//\n");
+  printf("// crossover table of auto_sort() (auto_sort.c), generated by ./sorting_methods -calibrate > auto_sort_table.h\n");
+  printf("//\n");
+  printf("// for each shape, the rules are in increasing order of max_n, and the last one has max_n equal to INT_MAX\n");
+  printf("//\n");
+  printf("\n");
+  printf("#include <limits.h>\n");
+  printf("\n");
+  printf("static const auto_sort_rule_t auto_sort_rules[] =\n");
+  printf("{ // shape                  max_n  function\n");
+  for(s = 0;s < AUTO_SORT_N_SHAPES;s++)
+  {
+    if((dist = find_input_distribution(shapes[s].input)) == NULL)
+    {
+      fprintf(stderr,"unknown input distribution %s --- 😒\n",shapes[s].input);
+      exit(1);
+    }
+    for(f = 0;f < n_functions;f++)
+      alive[f] = (sort_threads() > 1 || strncmp(functions[f].name,"parallel_",9) != 0) ? 1 : 0;
+    current = challenger = -1;
+    crossover_n = 0;
+    prev_n = 0;
+    for(k = 4;k <= MAX_K;k++)
+    {
+      n = (int)round(pow(10.0,0.25 * (double)k));
+      if(shapes[s].shape != AUTO_SORT_RANDOM && n < AUTO_SORT_MIN_N)
+        continue; // auto_sort() treats these as random
+      srand((unsigned int)k);
+      if(dist->function == NULL)
+        for(i = 0;i < n;i++)
+          master[i] = (T)rand();
+      else
+        (*dist->function)(master,n,(unsigned int)rand());
+      if(shapes[s].wide != 0)
+        for(i = 0,stride = INT_MAX / n;i < n;i++)
+          master[i] = master[i] * stride + rand() % stride; // the key v goes to [v*stride,(v+1)*stride)
+      reps = (n < MIN_ITEMS) ? MIN_ITEMS / n : 1;
+      for(b = 0;b < N_BATCHES;b++) // the batches of the routines are interleaved, so a slow moment affects them all
+        for(f = 0;f < n_functions;f++)
+          if(alive[f] != 0)
+          {
+            fprintf(stderr,"%s %8d %s         \r",shapes[s].input,n,functions[f].name);
+            t = measure_time();
+            for(r = 0;r < reps;r++)
+            {
+              memcpy(data,master,(size_t)n * sizeof(T));
+              (*functions[f].function)(data,0,n);
+            }
+            t = (measure_time() - t) / (double)reps;
+            if(b == 0 || t < times[f])
+              times[f] = t;
+            for(i = 1;i < n;i++)
+              if(data[i] < data[i - 1])
+              {
+                fprintf(stderr,"%s() failed for n=%d (sort error for i=%d, %s input) --- 😒\n",functions[f].name,n,i,dist->name);
+                exit(1);
+              }
+          }
+      for(f = 0,best = -1;f < n_functions;f++)
+        if(alive[f] != 0 && (best < 0 || times[f] < times[best]))
+          best = f;
+      if(current >= 0 && alive[current] != 0 && times[current] <= HYSTERESIS * times[best])
+        best = current;
+      else
+        for(f = 0;f < best;f++)
+          if(alive[f] != 0 && times[f] <= HYSTERESIS * times[best])
+          { // the first (simplest) of the routines that are about as fast
+            best = f;
+            break;
+          }
+      for(f = 0;f < n_functions;f++)
+        if(alive[f] != 0 && times[f] > GIVE_UP * times[best] && times[f] > GIVE_UP_TIME)
+          alive[f] = 0;
+      if(best == current)
+        challenger = -1;
+      else if(current >= 0 && alive[current] != 0 && best != challenger)
+      { // a new challenger (the crossover point, if it takes over, is between prev_n and n)
+        challenger = best;
+        crossover_n = (int)round(sqrt((double)prev_n * (double)n));
+      }
+      else
+      { // the challenger won twice in a row (or the current routine was given up, or this is the first n)
+        if(current >= 0)
+          printf("  { %s,%*s%9d, %s },\n",shapes[s].shape_name,21 - (int)strlen(shapes[s].shape_name),"",(best == challenger) ? crossover_n : (int)round(sqrt((double)prev_n * (double)n)),functions[current].name);
+        current = best;
+        challenger = -1;
+      }
+      prev_n = n;
+    }
+    printf("  { %s,%*s%9s, %s },\n",shapes[s].shape_name,21 - (int)strlen(shapes[s].shape_name),"","INT_MAX",functions[current].name);
+    fflush(stdout);
   }
-  functions[] =
+  printf("};\n");
+  fprintf(stderr,"%60s\r","");
+  free(alive);
+  free(times);
+  free(data);
+  free(master);
+  return 0;
+# undef MAX_K
+# undef MIN_ITEMS
+# undef N_BATCHES
+# undef HYSTERESIS
+# undef GIVE_UP
+# undef GIVE_UP_TIME
+}
+
+int main(int argc,char *argv[argc])
+{
+  static sort_entry_int functions[] =
   {
 #define EXPAND(name)  { name,# name }
     EXPAND(bubble_sort),
@@ -56,138 +705,184 @@ int main(int argc,char *argv[argc])
     EXPAND(merge_sort),
     EXPAND(heap_sort),
     EXPAND(rank_sort),
-    EXPAND(selection_sort)
+    EXPAND(selection_sort),
+    EXPAND(radix_sort),
+    EXPAND(intro_sort),
+    EXPAND(block_quick_sort),
+    EXPAND(dual_pivot_quick_sort),
+    EXPAND(heap_sort_4ary),
+    EXPAND(tim_sort),
+    EXPAND(block_merge_sort),
+    EXPAND(counting_sort),
+    EXPAND(bucket_sort),
+    EXPAND(quick_sort_simd),
+    EXPAND(merge_sort_simd),
+    EXPAND(merge_sort_bottom_up),
+    EXPAND(parallel_merge_sort),
+    EXPAND(parallel_quick_sort),
+    EXPAND(parallel_sample_sort),
+    EXPAND(auto_sort)
 #undef EXPAND
   };
-#define N_FUNCTIONS (int)(sizeof(functions) / sizeof(functions[0]))
+  static sort_entry_int calibration_functions[] =
+  { // the candidates of auto_sort(), in order of preference (see calibrate())
+#define EXPAND(name)  { name,# name }
+    EXPAND(insertion_sort),
+    EXPAND(quick_sort),
+    EXPAND(merge_sort),
+    EXPAND(radix_sort),
+    EXPAND(intro_sort),
+    EXPAND(block_quick_sort),
+    EXPAND(tim_sort),
+    EXPAND(counting_sort),
+    EXPAND(bucket_sort),
+    EXPAND(quick_sort_simd),
+    EXPAND(merge_sort_simd),
+    EXPAND(parallel_sample_sort)
+#undef EXPAND
+  };
+  static sort_entry_int parallel_functions[] =
+  { // also tested with large arrays (see test_parallel())
+#define EXPAND(name)  { name,# name }
+    EXPAND(parallel_merge_sort),
+    EXPAND(parallel_quick_sort),
+    EXPAND(parallel_sample_sort)
+#undef EXPAND
+  };
+  static sort_entry_int selection_functions[] =
+  {
+#define EXPAND(name)  { name,# name }
+    EXPAND(nth_element_median),
+    EXPAND(partial_sort_100),
+    EXPAND(top_k_10),
+    EXPAND(top_k_1000)
+#undef EXPAND
+  };
+#define N_FUNCTIONS(f) (int)(sizeof(f) / sizeof(f[0]))
+  char *type;
+  int i;
+  double memory;
 
   //
-  // test the functions
+  // external sort
   //
-  if(argc == 2 && strcmp(argv[1],"-test") == 0)
+  if(argc >= 4 && strcmp(argv[1],"-sort") == 0)
   {
-# define MAX_N   1000  // test array sizes up to this limit
-# define N_TESTS  100  // number of tests to perform for each array size
-    int i,j,k,n,first,one_after_last;
-    T master[MAX_N],data[MAX_N];
-
-    srand((unsigned int)time(NULL));
-    for(n = 1;n <= MAX_N;n++)
+    memory = 1024.0; // in MB
+    for(i = 4;i < argc;i++)
+      if(strcmp(argv[i],"-memory") == 0 && i + 1 < argc && (memory = atof(argv[++i])) > 0.0)
+        ;
+      else if(strcmp(argv[i],"-threads") == 0 && i + 1 < argc)
+        n_sort_threads = atoi(argv[++i]);
+      else
+        break; // unknown option
+    if(i == argc)
+      return external_sort(argv[2],argv[3],(size_t)(memory * 1048576.0));
+  }
+  //
+  // parse the command line arguments
+  //
+  type = "int";
+  for(i = 2;i < argc;i++)
+    if(argv[i][0] != '-')
+      type = argv[i];
+    else if(strcmp(argv[i],"-threads") == 0 && i + 1 < argc)
+      n_sort_threads = atoi(argv[++i]);
+    else if(strcmp(argv[i],"-wall") == 0)
+      measure_time = wall_time;
+    else if(strcmp(argv[i],"-dist") == 0 && i + 1 < argc)
     {
-      for(i = 0;i < n;i++)
-        master[i] = (T)((int)rand() % MAX_N);
-      first = 0;
-      one_after_last = n;
-      for(j = 0;j < N_TESTS;j++)
+      if(strcmp(argv[++i],"all") == 0)
+        input_distribution = NULL;
+      else if((input_distribution = find_input_distribution(argv[i])) == NULL)
       {
-        fprintf(stderr,"%4d[%4d,%4d] \r",n,first,one_after_last);
-        for(k = 0;k < N_FUNCTIONS;k++)
-        {
-          for(i = 0;i < first;i++)
-            data[i] = (T)(-1);
-          for(;i < one_after_last;i++)
-            data[i] = master[i];
-          for(;i < n;i++)
-            data[i] = (T)(-1);
-          (*functions[k].function)(data,first,one_after_last);
-          if(data[first] < (T)(0) || (first > 0 && data[first - 1] != (T)(-1)) || (one_after_last < n && data[one_after_last] != (T)(-1)))
-          {
-            fprintf(stderr,"%s() failed for n=%d, first=%d, and one_after_last=%d (access error) --- 😒\n",functions[k].name,n,first,one_after_last);
-            exit(1);
-          }
-          for(i = first + 1;i < one_after_last;i++)
-            if(data[i] < data[i - 1])
-            {
-              show(data,first,one_after_last);
-              fprintf(stderr,"%s() failed for n=%d, first=%d, and one_after_last=%d (sort error for i=%d) --- 😒\n",functions[k].name,n,first,one_after_last,i);
-              exit(1);
-            }
-        }
-        first = (int)rand() % (1 + (3 * n) / 4);
-        do
-          one_after_last = (int)rand() % (1 + n);
-        while(one_after_last <= first);
+        fprintf(stderr,"unknown input distribution %s --- 😒\n",argv[i]);
+        break;
       }
     }
-    //
-    // done
-    //
-    printf("No errors found --- 😀\n");
-    return 0;
-# undef MAX_N
-# undef N_TESTS
-  }
-  //
-  // measure the cpu time of all sorting routines
-  //
-  if(argc == 2 && strcmp(argv[1],"-measure") == 0)
-  {
-# define MAX_N          10000000  // largest array size
-# define N_MEASUREMENTS     1000  // number of measurements to perform for each value of n
-# define N_EXTRA              50  // half the number of extra measurements (to discard N_EXTRA possible outliers on each side)
-# define MAX_TIME           60.0  // maximum amount of time, in seconds, spent in a value of n
-    double v,w,t[N_MEASUREMENTS + 2 * N_EXTRA];
-    int f_idx,n_idx,n,i,j;
-    T *data;
-
-    data = (T *)malloc((size_t)MAX_N * sizeof(T));
-    if(data == NULL)
+    else if(strcmp(argv[i],"-killer") == 0)
+      input_distribution = find_input_distribution("killer");
+    else if(strcmp(argv[i],"-counters") == 0)
+      use_counters = 1;
+    else if(strcmp(argv[i],"-strings") == 0 && i + 1 < argc)
     {
-      fprintf(stderr,"unable to allocate memory for the data array --- 😒\n");
-      exit(1);
+      if(set_string_generator(argv[++i]) == 0)
+      {
+        fprintf(stderr,"unknown string generator %s --- 😒\n",argv[i]);
+        break;
+      }
     }
-    for(f_idx = 0;f_idx < N_FUNCTIONS;f_idx++)
+    else
+      break; // unknown option
+  if(argc >= 2 && i == argc && strcmp(argv[1],"-calibrate") == 0 && strcmp(type,"int") == 0)
+    return calibrate(calibration_functions,N_FUNCTIONS(calibration_functions));
+  if(argc >= 2 && i == argc && (strcmp(argv[1],"-test") == 0 || strcmp(argv[1],"-measure") == 0))
+  {
+    //
+    // test or measure the cpu time of all sorting routines of the given data type (for int, also of the selection
+    // routines, and test the parallel sorting routines with large arrays)
+    //
+    if(strcmp(type,"int") == 0)
     {
-      printf("# %s\n",functions[f_idx].name);
-      printf("#      n  min time  max time  avg time   std dev\n");
-      printf("#------- --------- --------- --------- ---------\n");
-      for(n_idx = 10;n_idx <= 80;n_idx++)
+      if(argv[1][1] == 't')
       {
-        n = (int)round(pow(10.0,0.1 * (double)n_idx));
-        if(n <= MAX_N)
-        {
-          srand((unsigned int)n_idx); // make sure are sorting routines receive the same data
-          for(i = 0;i < N_MEASUREMENTS + 2 * N_EXTRA;i++)
-          {
-            for(j = 0;j < n;j++)
-              data[j] = (T)rand();
-            v = cpu_time();
-            (*functions[f_idx].function)(data,0,n);
-            v = cpu_time() - v;
-            // insertion sort!
-            for(j = i;j > 0 && t[j - 1] > v;j--)
-              t[j] = t[j - 1];
-            t[j] = v;
-          }
-          v = 0.0;
-          for(i = N_EXTRA;i < N_EXTRA + N_MEASUREMENTS;i++)
-            v += t[i];
-          v /= (double)N_MEASUREMENTS;
-          w = 0.0;
-          for(i = N_EXTRA;i < N_EXTRA + N_MEASUREMENTS;i++)
-            w += (t[i] - v) * (t[i] - v);
-          w /= (double)N_MEASUREMENTS;
-          printf("%8d %.3e %.3e %.3e %.3e\n",n,t[N_EXTRA],t[N_EXTRA + N_MEASUREMENTS - 1],v,sqrt(w));
-          fflush(stdout);
-          if((double)N_MEASUREMENTS * v >= MAX_TIME)
-            break; // too much time spent on this value of n; skip the remining ones
-        }
+        if(test_int(functions,N_FUNCTIONS(functions)) != 0 || test_parallel(parallel_functions,N_FUNCTIONS(parallel_functions)) != 0)
+          return 1;
+        return test_selection();
       }
-      printf("#------- --------- --------- --------- ---------\n");
-      printf("\n\n");
-      fflush(stdout);
+      return (measure_int(functions,N_FUNCTIONS(functions)) != 0) ? 1 : measure_int(selection_functions,N_FUNCTIONS(selection_functions));
     }
-    free(data);
-    return 0;
-# undef MAX_N
-# undef N_MEASUREMENTS
-# undef N_EXTRA
-# undef MAX_TIME
+    if(argv[1][1] == 't' && (strcmp(type,"float") == 0 || strcmp(type,"double") == 0))
+    { // also test the order of -0.0, +0.0, NaNs, ... of the radix sorts
+      if(((type[0] == 'f') ? test_f32(functions_f32,N_FUNCTIONS(functions_f32)) : test_f64(functions_f64,N_FUNCTIONS(functions_f64))) != 0)
+        return 1;
+      return test_float_radix();
+    }
+#   define DISPATCH(name,suffix,f)  do if(strcmp(type,name) == 0)                                  \
+                                        return (argv[1][1] == 't') ? test_ ## suffix(f,N_FUNCTIONS(f)) \
+                                                                   : measure_ ## suffix(f,N_FUNCTIONS(f)); \
+                                      while(0)
+    DISPATCH("int32",i32,functions_i32);
+    DISPATCH("int64",i64,functions_i64);
+    DISPATCH("int32z",i32z,functions_i32z);
+    DISPATCH("int64z",i64z,functions_i64z);
+    DISPATCH("float",f32,functions_f32);
+    DISPATCH("double",f64,functions_f64);
+    DISPATCH("record16",r16,functions_r16);
+    DISPATCH("record64",r64,functions_r64);
+    DISPATCH("record128",r128,functions_r128);
+    DISPATCH("record256",r256,functions_r256);
+    DISPATCH("string",str,functions_str);
+#   undef DISPATCH
+    fprintf(stderr,"unknown data type %s --- 😒\n",type);
   }
   //
   // usage message
   //
-  fprintf(stderr,"usage: %s -test     # test all sorting routines\n",argv[0]);
-  fprintf(stderr,"       %s -measure  # measure the cpu time of all sorting routines\n",argv[0]);
+  fprintf(stderr,"usage: %s -test [type] [options]     # test all sorting (and, for int, selection) routines\n",argv[0]);
+  fprintf(stderr,"       %s -measure [type] [options]  # measure the cpu time of all sorting routines\n",argv[0]);
+  fprintf(stderr,"       %s -calibrate [options] > auto_sort_table.h\n",argv[0]);
+  fprintf(stderr,"                                          # measure the crossover table of auto_sort() (then compile again)\n");
+  fprintf(stderr,"       %s -sort input_file output_file [-memory MB] [-threads n]\n",argv[0]);
+  fprintf(stderr,"                                          # sort a binary file of ints (which may be larger than the memory)\n");
+  fprintf(stderr,"       type is one of int (default), int32, int64, int32z, int64z, float, double, record16, record64, record128,\n");
+  fprintf(stderr,"       record256, or string\n");
+  fprintf(stderr,"       (int32z and int64z use size_t indices, so they can sort arrays with 2^31 or more items; for the record sizes\n");
+  fprintf(stderr,"       larger than 16 bytes, direct sorting is compared with indirect sorting)\n");
+  fprintf(stderr,"options: -threads n  # number of threads of the parallel sorting routines (default: one per processor)\n");
+  fprintf(stderr,"         -wall       # measure the wall-clock time instead of the cpu time\n");
+  fprintf(stderr,"         -dist d     # input data distribution (default: random), or all for all of them, one after the other\n");
+  fprintf(stderr,"         -killer     # the same as -dist killer\n");
+  fprintf(stderr,"         -counters   # also report the medians of some hardware performance counters (GNU/Linux only)\n");
+  fprintf(stderr,"         -strings g  # the random strings of the string type (default: urls)\n");
+  fprintf(stderr,"distributions:");
+  for(i = 0;i < n_input_distributions;i++)
+    fprintf(stderr," %s",input_distributions[i].name);
+  fprintf(stderr,"\n");
+  fprintf(stderr,"string generators:");
+  for(i = 0;i < n_string_generators;i++)
+    fprintf(stderr," %s",string_generator_name(i));
+  fprintf(stderr,"\n");
   return 1;
+#undef N_FUNCTIONS
 }
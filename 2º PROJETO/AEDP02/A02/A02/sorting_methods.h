@@ -6,6 +6,10 @@
 
 #define _SORTING_METHODS_
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
 typedef int T;
 typedef void (*sort_function_t)(T *data,int first,int one_after_last);
 
@@ -18,5 +22,194 @@ void merge_sort    (T *data,int first,int one_after_last);
 void heap_sort     (T *data,int first,int one_after_last);
 void rank_sort     (T *data,int first,int one_after_last);
 void selection_sort(T *data,int first,int one_after_last);
+void radix_sort    (T *data,int first,int one_after_last);
+
+void intro_sort    (T *data,int first,int one_after_last);
+void block_quick_sort(T *data,int first,int one_after_last);
+void dual_pivot_quick_sort(T *data,int first,int one_after_last);
+void heap_sort_4ary  (T *data,int first,int one_after_last);
+void tim_sort        (T *data,int first,int one_after_last); // stable, O(n) for presorted data
+void block_merge_sort(T *data,int first,int one_after_last); // stable, O(sqrt(n)) extra memory
+void counting_sort   (T *data,int first,int one_after_last); // O(n+k) for keys in a range of size k (small k only)
+void bucket_sort     (T *data,int first,int one_after_last); // O(n) on average for keys spread over a bounded range
+
+void small_sort     (T *data,int first,int one_after_last); // up to 64 items (sorting networks, AVX2 if available)
+void quick_sort_simd(T *data,int first,int one_after_last);
+void merge_sort_simd(T *data,int first,int one_after_last);
+void merge_simd     (T *a,int m,T *b,int l,T *out); // merge of two sorted arrays (bitonic merging network, AVX2 if available)
+
+void merge_sort_bottom_up       (T *data,int first,int one_after_last);
+void merge_sort_bottom_up_buffer(T *data,int first,int one_after_last,T *buffer); // buffer[0..one_after_last-first-1]
+
+void quick_sort_partition(T *data,int first,int one_after_last,int *first_equal,int *one_after_equal);
+void three_way_partition (T *data,int first,int one_after_last,int *first_equal,int *one_after_equal); // pivot: data[one_after_last-1]
+void median_of_3_killer(int *values,int n); // adversarial input for quick_sort()
+
+//
+// adaptive sorting (auto_sort.c); a small sample of the data gives its shape, and the crossover table of
+// auto_sort_table.h (generated by ./sorting_methods -calibrate) gives the fastest sorting routine for that shape and n
+//
+
+#define AUTO_SORT_RANDOM       0  // none of the following
+#define AUTO_SORT_PRESORTED    1  // mostly ascending or mostly descending
+#define AUTO_SORT_DUPLICATES   2  // few distinct keys
+#define AUTO_SORT_NARROW       3  // keys in a range not much wider than the number of items
+#define AUTO_SORT_N_SHAPES     4
+#define AUTO_SORT_MIN_N     1000  // the shape of smaller arrays is not estimated (they are taken as random)
+
+typedef struct
+{
+  int shape;                // one of the AUTO_SORT_* shapes
+  int max_n;                // the rule applies to arrays of that shape with up to max_n items
+  sort_function_t function; // the sorting routine to use
+}
+auto_sort_rule_t;
+
+int  auto_sort_shape(T *data,int first,int one_after_last);
+void auto_sort      (T *data,int first,int one_after_last);
+
+//
+// selection (nth_element.c); linear time, on average and in the worst case
+//
+
+void nth_element (T *data,int first,int nth,int one_after_last);    // data[nth] as if sorted, smaller items before, larger after
+void partial_sort(T *data,int first,int middle,int one_after_last); // the smallest middle-first items, sorted, at the start
+void top_k       (T *data,int first,int one_after_last,int k);      // the k largest items, sorted, at the end
+
+//
+// input data distributions (input_distributions.c); the values are non-negative integers
+//
+
+typedef struct
+{
+  void (*function)(int *values,int n,unsigned int seed); // NULL means uniformly distributed random keys (GT_RANDOM)
+  char *name;
+  int max_n;                                             // largest usable n (0 means no limit)
+  int reuse;                                             // 1 if the values do not depend on the seed
+}
+input_distribution_t;
+
+extern input_distribution_t input_distributions[];
+extern int n_input_distributions;
+input_distribution_t *find_input_distribution(char *name); // NULL if there is no distribution with that name
+
+//
+// parallel sorting routines
+//
+
+#define MAX_SORT_THREADS  256
+
+extern int n_sort_threads; // number of threads to use (0, the default, means one thread per online processor)
+int sort_threads(void);    // the actual number of threads to use
+
+void parallel_merge_sort(T *data,int first,int one_after_last);
+void parallel_quick_sort(T *data,int first,int one_after_last);
+void parallel_sample_sort(T *data,int first,int one_after_last);
+
+//
+// external sort of a binary file of T items (returns 0 on success)
+//
+
+int external_sort(char *input_file_name,char *output_file_name,size_t memory_size);
+
+//
+// string sorting routines (string_sort.c); the strings are ordered as by strcmp()
+//
+
+void multikey_quick_sort(char **data,int first,int one_after_last); // 3-way radix quick sort (Bentley and Sedgewick)
+void msd_radix_sort     (char **data,int first,int one_after_last); // with a character cache (Karkkainen and Rantala)
+void lcp_merge_sort     (char **data,int first,int one_after_last); // stable, uses longest common prefixes (Ng and Kakehi)
+
+//
+// strings for the tests and measurements (string_generators.c)
+//
+
+extern int n_string_generators;
+char *string_generator_name(int i);
+int   set_string_generator(char *name); // urls (default), paths, words, or keys; returns 0 if there is no such generator
+char *random_string(void);              // a random string of that kind (never empty)
+char *string_of_int(int v);             // strcmp() orders these strings as the integers v (-1 gives an empty string)
+void  strings_reset(void);              // forget all strings (their memory is reused)
+
+//
+// data types of the type-generic sorting routines (see sorting_methods_template.h)
+//
+//   suffix  data type   comparison
+//   i32     int32_t     a < b
+//   i64     int64_t     a < b
+//   i32z    int32_t     a < b          (size_t indices)
+//   i64z    int64_t     a < b          (size_t indices)
+//   f32     float       a < b          (radix sort: see float_radix_key())
+//   f64     double      a < b          (radix sort: see double_radix_key())
+//   r16     record16_t  a.key < b.key
+//   r64     record64_t  a.key < b.key  (and the indirect sorting routines, see indirect_sort_template.h)
+//   r128    record128_t a.key < b.key  (idem)
+//   r256    record256_t a.key < b.key  (idem)
+//   str     string_t    strcmp(a,b) < 0
+//
+
+typedef struct
+{
+  int64_t key;     // sort key
+  int64_t payload; // data that goes along with the key
+}
+record16_t;
+
+typedef struct
+{
+  int64_t key;       // sort key
+  int64_t tag;       // data that goes along with the key (the tests store the position of each record here)
+  char payload[48];  // more data that goes along with the key
+}
+record64_t;
+
+typedef struct
+{
+  int64_t key;       // sort key
+  int64_t tag;       // data that goes along with the key (the tests store the position of each record here)
+  char payload[112]; // more data that goes along with the key
+}
+record128_t;
+
+typedef struct
+{
+  int64_t key;       // sort key
+  int64_t tag;       // data that goes along with the key (the tests store the position of each record here)
+  char payload[240]; // more data that goes along with the key
+}
+record256_t;
+
+typedef char *string_t; // (GT must be a single name: GT a,b; declares two items)
+
+//
+// order-preserving unsigned integer keys of IEEE 754 floating point numbers (GT_RADIX_KEY of the f32 and f64
+// instances); the bits of a negative number are all flipped, and the sign bit of a non-negative number is set, so
+// that -inf < ... < -0.0 < +0.0 < ... < +inf, and then the key of -inf is subtracted (modulo 2^32 or 2^64), so that
+// -inf gets the key 0 and the NaNs with the sign bit set, whose keys were smaller than that of -inf, wrap around to
+// the top; so all NaNs come after +inf (first those with the sign bit clear); the map is one-to-one, so two numbers
+// have the same key only if they have the same bits
+//
+
+static inline uint32_t float_radix_key(float x)
+{
+  uint32_t u;
+
+  memcpy(&u,&x,sizeof(u));
+  u = (u & 0x80000000u) ? ~u : u | 0x80000000u;
+  return u - 0x007FFFFFu; // the key of -inf was 0x007FFFFF
+}
+
+static inline uint64_t double_radix_key(double x)
+{
+  uint64_t u;
+
+  memcpy(&u,&x,sizeof(u));
+  u = (u & 0x8000000000000000u) ? ~u : u | 0x8000000000000000u;
+  return u - 0x000FFFFFFFFFFFFFu; // the key of -inf was 0x000FFFFFFFFFFFFF
+}
+
+#define GT_CONCAT_(name,suffix)  name ## _ ## suffix
+#define GT_CONCAT(name,suffix)   GT_CONCAT_(name,suffix)
+#define GT_NAME(name)            GT_CONCAT(name,GT_SUFFIX) // name of the instance of a template function
 
 #endif
@@ -0,0 +1,334 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// test and measurement code of sorting_methods.c, for one data type
+//
+// Like sorting_methods_template.h, this file is a "template" that is included once for each data type. Besides
+// GT, GT_SUFFIX, and GT_LESS(a,b), it needs
+//
+//   GT_SET(a,v)   store the (small, non-negative or -1) integer v in the item a
+//   GT_RANDOM(a)  store a random value in the item a
+//   GT_KEY(a)     the key of the item a, converted to a double (used by the access checks and by show)
+//
+// and, optionally,
+//
+//   GT_INDEX      the type of the first and one_after_last arguments of the sorting routines (the default is int)
+//   GT_TAG(a)     an integer field of the item a that is not compared; if it is defined, the test sets the tag of each
+//                 item to its position, checks that the sorted items are a permutation of the original ones (each tag
+//                 appears once, together with the rest of its item), and checks that the sorting routines marked as
+//                 stable keep the tags of equal items in increasing order
+//   GT_NEW_DATA() called before the items of a new data set are generated, so that the memory used by the items of the
+//                 previous data set (for example, strings) can be reused
+//
+// The measurements use the measure_time() function (cpu_time() or wall_time()), and the input data comes from the
+// input_distribution distribution (all of them, one after the other, if it is NULL); if use_counters is not zero the
+// available hardware performance counters (perf_counters.h) are also read; these are defined in sorting_methods.c.
+// The statistics are computed with the help of streaming_quantile.h, and the data array of the measurements is
+// placed in huge pages, if possible (huge_pages.h).
+// It defines the GT_NAME(sort_entry) type (a function, its name, and whether it is stable) and the GT_NAME(test) and
+// GT_NAME(measure) functions, and it undefines all GT_* macros at the end.
+//
+
+#ifndef GT_INDEX
+# define GT_INDEX  int
+#endif
+
+typedef struct
+{
+  void (*function)(GT *data,GT_INDEX first,GT_INDEX one_after_last);
+  char *name;
+  int stable; // 1 if the sorting routine is stable
+}
+GT_NAME(sort_entry);
+
+static void GT_NAME(show)(GT *data,int first,int one_after_last)
+{
+  int i;
+
+  printf("[%2d,%2d]",first,one_after_last - 1);
+  for(i = first;i < one_after_last;i++)
+    printf(" %5g",GT_KEY(data[i]));
+  printf("\n");
+}
+
+//
+// qsort() comparison function (for the reference sort of the tests)
+//
+static int GT_NAME(compare)(const void *a,const void *b)
+{
+  return GT_LESS(*(const GT *)a,*(const GT *)b) ? -1 : GT_LESS(*(const GT *)b,*(const GT *)a) ? 1 : 0;
+}
+
+//
+// test the functions (with data from the input_distribution distribution, or from all of them); the output of each
+// function must be sorted, it must not touch the items outside [first,one_after_last), and each of its items must be
+// equivalent (neither is less than the other) to the item in the same position of the output of qsort(), so that
+// a function that loses, duplicates, or rewrites keys is caught
+//
+static int GT_NAME(test)(GT_NAME(sort_entry) *functions,int n_functions)
+{
+# define MAX_N   1000  // test array sizes up to this limit
+# define N_TESTS  100  // number of tests to perform for each array size
+  int d,i,j,k,n,first,one_after_last;
+  static int values[MAX_N];
+  static GT master[MAX_N],data[MAX_N],sorted[MAX_N];
+#ifdef GT_TAG
+  static char seen[MAX_N];
+  int tag;
+#endif
+
+  srand((unsigned int)time(NULL));
+  for(d = 0;d < n_input_distributions;d++)
+    if(input_distribution == NULL || input_distribution == &input_distributions[d])
+      for(n = 1;n <= MAX_N;n++)
+      {
+#ifdef GT_NEW_DATA
+        GT_NEW_DATA();
+#endif
+        if(input_distributions[d].function == NULL)
+          for(i = 0;i < n;i++)
+            GT_SET(master[i],(int)rand() % MAX_N);
+        else
+        {
+          (*input_distributions[d].function)(values,n,(unsigned int)rand());
+          for(i = 0;i < n;i++)
+            GT_SET(master[i],values[i]);
+        }
+#ifdef GT_TAG
+        for(i = 0;i < n;i++)
+          GT_TAG(master[i]) = i;
+#endif
+        first = 0;
+        one_after_last = n;
+        for(j = 0;j < N_TESTS;j++)
+        {
+          fprintf(stderr,"%4d[%4d,%4d] \r",n,first,one_after_last);
+          memcpy(&sorted[first],&master[first],(size_t)(one_after_last - first) * sizeof(GT));
+          qsort(&sorted[first],(size_t)(one_after_last - first),sizeof(GT),GT_NAME(compare));
+          for(k = 0;k < n_functions;k++)
+          {
+            for(i = 0;i < first;i++)
+              GT_SET(data[i],-1);
+            for(;i < one_after_last;i++)
+              data[i] = master[i];
+            for(;i < n;i++)
+              GT_SET(data[i],-1);
+            (*functions[k].function)(data,first,one_after_last);
+            if(GT_KEY(data[first]) < 0.0 || (first > 0 && GT_KEY(data[first - 1]) != -1.0) || (one_after_last < n && GT_KEY(data[one_after_last]) != -1.0))
+            {
+              fprintf(stderr,"%s() failed for n=%d, first=%d, and one_after_last=%d (access error, %s input) --- 😒\n",functions[k].name,n,first,one_after_last,input_distributions[d].name);
+              exit(1);
+            }
+            for(i = first + 1;i < one_after_last;i++)
+              if(GT_LESS(data[i],data[i - 1]))
+              {
+                GT_NAME(show)(data,first,one_after_last);
+                fprintf(stderr,"%s() failed for n=%d, first=%d, and one_after_last=%d (sort error for i=%d, %s input) --- 😒\n",functions[k].name,n,first,one_after_last,i,input_distributions[d].name);
+                exit(1);
+              }
+            for(i = first;i < one_after_last;i++)
+              if(GT_LESS(data[i],sorted[i]) || GT_LESS(sorted[i],data[i]))
+              {
+                GT_NAME(show)(data,first,one_after_last);
+                fprintf(stderr,"%s() failed for n=%d, first=%d, and one_after_last=%d (lost, duplicated, or changed key for i=%d, %s input) --- 😒\n",functions[k].name,n,first,one_after_last,i,input_distributions[d].name);
+                exit(1);
+              }
+#ifdef GT_TAG
+            for(i = first;i < one_after_last;i++)
+              seen[i] = 0;
+            for(i = first;i < one_after_last;i++)
+            {
+              tag = (int)GT_TAG(data[i]);
+              if(tag < first || tag >= one_after_last || seen[tag] != 0 || memcmp(&data[i],&master[tag],sizeof(GT)) != 0)
+              {
+                GT_NAME(show)(data,first,one_after_last);
+                fprintf(stderr,"%s() failed for n=%d, first=%d, and one_after_last=%d (lost, duplicated, or damaged item for i=%d, %s input) --- 😒\n",functions[k].name,n,first,one_after_last,i,input_distributions[d].name);
+                exit(1);
+              }
+              seen[tag] = 1;
+            }
+            for(i = first + 1;i < one_after_last && functions[k].stable != 0;i++)
+              if(!GT_LESS(data[i - 1],data[i]) && GT_TAG(data[i]) < GT_TAG(data[i - 1]))
+              {
+                GT_NAME(show)(data,first,one_after_last);
+                fprintf(stderr,"%s() failed for n=%d, first=%d, and one_after_last=%d (stability error for i=%d, %s input) --- 😒\n",functions[k].name,n,first,one_after_last,i,input_distributions[d].name);
+                exit(1);
+              }
+#endif
+          }
+          first = (int)rand() % (1 + (3 * n) / 4);
+          do
+            one_after_last = (int)rand() % (1 + n);
+          while(one_after_last <= first);
+        }
+      }
+  //
+  // done
+  //
+  printf("No errors found --- 😀\n");
+  return 0;
+# undef MAX_N
+# undef N_TESTS
+}
+
+//
+// measure the cpu time (or the wall-clock time) of all sorting routines (with data from the input_distribution
+// distribution, or from all of them, one table for each function and distribution)
+//
+// For each n, the sorting routine is measured until the 95% confidence interval of the median time is within
+// MAX_RELATIVE_ERROR of the median (but at least MIN_MEASUREMENTS and at most MAX_MEASUREMENTS times). The median and
+// the quartiles are estimated as the times arrive (streaming_quantile.h), and the half width of the confidence
+// interval is estimated by 1.96*sqrt(pi/2)*(q3-q1)/(1.349*sqrt(count)), which assumes that the bulk of the times is
+// roughly normally distributed (the outliers do not matter). The medians of the hardware performance counters, if
+// requested and available, are placed after the time columns.
+//
+static int GT_NAME(measure)(GT_NAME(sort_entry) *functions,int n_functions)
+{
+# define MAX_N              10000000  // largest array size
+# define MAX_BYTES        1073741824  // largest array size, in bytes (this limits the array size of large items)
+# define MIN_MEASUREMENTS         20  // minimum number of measurements for each value of n
+# define MAX_MEASUREMENTS       1000  // maximum number of measurements for each value of n
+# define MAX_RELATIVE_ERROR     0.02  // target relative half width of the confidence interval of the median
+# define MAX_TIME               60.0  // maximum amount of time, in seconds, spent in a value of n
+  double v,w,mean,m2,min_time,max_time,median,half_width,total_time,counts[N_PERF_COUNTERS];
+  quantile_t q1,q2,q3,c_medians[N_PERF_COUNTERS];
+  int d,c,f_idx,n_idx,n,max_n,i,j,*values,n_counters,pages;
+  input_distribution_t *dist;
+  GT *data;
+
+  max_n = ((double)MAX_N * (double)sizeof(GT) > (double)MAX_BYTES) ? (int)(MAX_BYTES / sizeof(GT)) : MAX_N;
+  data = (GT *)huge_pages_alloc((size_t)max_n * sizeof(GT),&pages); // fewer TLB misses
+  values = (int *)malloc((size_t)max_n * sizeof(int));
+  if(data == NULL || values == NULL)
+  {
+    fprintf(stderr,"unable to allocate memory for the data array --- 😒\n");
+    exit(1);
+  }
+  n_counters = 0;
+  if(use_counters != 0 && (n_counters = perf_counters_open()) == 0)
+    fprintf(stderr,"the hardware performance counters are not available (not supported or not permitted), measuring only the time --- 😒\n");
+  for(d = 0;d < n_input_distributions;d++)
+  {
+    dist = &input_distributions[d];
+    if(input_distribution != NULL && input_distribution != dist)
+      continue;
+    for(f_idx = 0;f_idx < n_functions;f_idx++)
+    {
+      printf("# %s\n",functions[f_idx].name);
+      printf("# input: %s\n",dist->name);
+      printf("# memory: %s\n",huge_pages_names[pages]);
+      printf("#      n  min time  max time  avg time   std dev    median count");
+      for(c = 0;c < N_PERF_COUNTERS;c++)
+        if(n_counters > 0 && perf_counter_available[c] != 0)
+          printf(" %13s",perf_counter_names[c]);
+      printf("\n");
+      printf("#------- --------- --------- --------- --------- --------- -----");
+      for(c = 0;c < N_PERF_COUNTERS;c++)
+        if(n_counters > 0 && perf_counter_available[c] != 0)
+          printf(" -------------");
+      printf("\n");
+      for(n_idx = 10;n_idx <= 80;n_idx++)
+      {
+        n = (int)round(pow(10.0,0.1 * (double)n_idx));
+        if(n > max_n || (dist->max_n > 0 && n > dist->max_n))
+          break;
+        srand((unsigned int)n_idx); // make sure are sorting routines receive the same data
+        if(dist->reuse != 0)
+          (*dist->function)(values,n,0u); // the same data for all measurements
+        quantile_init(&q1,0.25);
+        quantile_init(&q2,0.50);
+        quantile_init(&q3,0.75);
+        for(c = 0;c < N_PERF_COUNTERS;c++)
+          quantile_init(&c_medians[c],0.5);
+        mean = m2 = total_time = min_time = max_time = 0.0;
+        for(i = 0;;)
+        {
+#ifdef GT_NEW_DATA
+          GT_NEW_DATA();
+#endif
+          if(dist->function == NULL)
+            for(j = 0;j < n;j++)
+              GT_RANDOM(data[j]);
+          else
+          {
+            if(dist->reuse == 0)
+              (*dist->function)(values,n,(unsigned int)(1000003 * n_idx + i));
+            for(j = 0;j < n;j++)
+              GT_SET(data[j],values[j]);
+          }
+          if(n_counters > 0)
+            perf_counters_start();
+          v = measure_time();
+          (*functions[f_idx].function)(data,0,n);
+          v = measure_time() - v;
+          if(n_counters > 0)
+          {
+            perf_counters_stop(counts);
+            for(c = 0;c < N_PERF_COUNTERS;c++)
+              quantile_add(&c_medians[c],counts[c]);
+          }
+          //
+          // update the statistics (O(1) work per measurement)
+          //
+          if(i == 0 || v < min_time)
+            min_time = v;
+          if(i == 0 || v > max_time)
+            max_time = v;
+          i++;
+          w = v - mean; // Welford's method for the mean and the variance
+          mean += w / (double)i;
+          m2 += w * (v - mean);
+          quantile_add(&q1,v);
+          quantile_add(&q2,v);
+          quantile_add(&q3,v);
+          total_time += v;
+          //
+          // enough?
+          //
+          median = quantile_value(&q2);
+          half_width = 1.96 * 1.2533 * (quantile_value(&q3) - quantile_value(&q1)) / (1.349 * sqrt((double)i));
+          if(total_time >= MAX_TIME || i >= MAX_MEASUREMENTS || (i >= MIN_MEASUREMENTS && half_width <= MAX_RELATIVE_ERROR * median))
+            break;
+        }
+        printf("%8d %.3e %.3e %.3e %.3e %.3e %5d",n,min_time,max_time,mean,sqrt(m2 / (double)i),median,i);
+        for(c = 0;c < N_PERF_COUNTERS;c++)
+          if(n_counters > 0 && perf_counter_available[c] != 0)
+            printf(" %13.6e",quantile_value(&c_medians[c]));
+        printf("\n");
+        fflush(stdout);
+        if((double)MAX_MEASUREMENTS * median >= MAX_TIME)
+          break; // a sorting routine this slow would take too much time for the next values of n; skip them
+      }
+      printf("#------- --------- --------- --------- --------- --------- -----");
+      for(c = 0;c < N_PERF_COUNTERS;c++)
+        if(n_counters > 0 && perf_counter_available[c] != 0)
+          printf(" -------------");
+      printf("\n\n\n");
+      fflush(stdout);
+    }
+  }
+  if(n_counters > 0)
+    perf_counters_close();
+  free(values);
+  huge_pages_free(data,(size_t)max_n * sizeof(GT),pages);
+  return 0;
+# undef MAX_N
+# undef MAX_BYTES
+# undef MIN_MEASUREMENTS
+# undef MAX_MEASUREMENTS
+# undef MAX_RELATIVE_ERROR
+# undef MAX_TIME
+}
+
+#undef GT
+#undef GT_SUFFIX
+#undef GT_LESS
+#undef GT_SET
+#undef GT_RANDOM
+#undef GT_KEY
+#undef GT_RADIX_KEY
+#undef GT_RADIX_KEY_BITS
+#undef GT_INDEX
+#undef GT_INDIRECT_KEY
+#undef GT_TAG
+#undef GT_NEW_DATA
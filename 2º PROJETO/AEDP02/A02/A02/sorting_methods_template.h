@@ -0,0 +1,294 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// type-generic versions of the sorting routines of sorting_methods.h
+//
+// This file is a "template": it has no include guard and it is meant to be included once for each data type,
+// as in
+//
+//   #define GT            int64_t      // the data type of the items being sorted
+//   #define GT_SUFFIX     i64          // suffix appended to the function names (quick_sort_i64, ...)
+//   #define GT_LESS(a,b)  ((a) < (b))  // strict weak ordering; it is expanded inline in the inner loops
+//   #include "sorting_methods_template.h"
+//
+// The comparison is a macro, and not a function pointer, so that the compiler can specialise every comparison
+// for the data type at hand (for records, GT_LESS will usually compare only the key of each item).
+// All other relational operations are derived from GT_LESS (a > b is GT_LESS(b,a), a <= b is !GT_LESS(b,a), ...).
+// The GT_* macros are NOT undefined at the end of this file; the code that includes it has to do that.
+//
+// The array indices have type GT_INDEX, which is int if it is not defined. To sort arrays with 2^31 or more items
+// define it as size_t; the code does not rely on the indices being signed (no index is ever decremented below
+// first), and the midpoints are computed as first+(one_after_last-first)/2, which does not overflow.
+//
+
+#include <stdlib.h>
+#include "sorting_methods.h"
+
+#ifndef GT_INDEX
+# define GT_INDEX  int
+#endif
+
+static inline void GT_NAME(bubble_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,i_low,i_high,i_last;
+
+  if(one_after_last - first < 2)
+    return; // nothing to do (and, for an unsigned GT_INDEX, one_after_last - 1 may not be valid)
+  i_low = first;
+  i_high = one_after_last - 1;
+  while(i_low < i_high)
+  {
+    for(i = i_last = i_low;i < i_high;i++)
+      if(GT_LESS(data[i + 1],data[i]))
+      {
+        GT tmp = data[i];
+        data[i] = data[i + 1];
+        data[i + 1] = tmp;
+        i_last = i;
+      }
+    i_high = i_last;
+  }
+}
+
+static inline void GT_NAME(shaker_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,i_low,i_high,i_last;
+
+  if(one_after_last - first < 2)
+    return; // nothing to do (and, for an unsigned GT_INDEX, one_after_last - 1 may not be valid)
+  i_low = first;
+  i_high = one_after_last - 1;
+  while(i_low < i_high)
+  {
+    // up pass
+    for(i = i_last = i_low;i < i_high;i++)
+      if(GT_LESS(data[i + 1],data[i]))
+      {
+        GT tmp = data[i];
+        data[i] = data[i + 1];
+        data[i + 1] = tmp;
+        i_last = i;
+      }
+    i_high = i_last;
+    // down pass
+    for(i = i_last = i_high;i > i_low;i--)
+      if(GT_LESS(data[i],data[i - 1]))
+      {
+        GT tmp = data[i];
+        data[i] = data[i - 1];
+        data[i - 1] = tmp;
+        i_last = i;
+      }
+    i_low = i_last;
+  }
+}
+
+static inline void GT_NAME(insertion_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,j;
+
+  for(i = first + 1;i < one_after_last;i++)
+  {
+    GT tmp = data[i];
+    for(j = i;j > first && GT_LESS(tmp,data[j - 1]);j--)
+      data[j] = data[j - 1];
+    data[j] = tmp;
+  }
+}
+
+static inline void GT_NAME(Shell_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,j,h;
+
+  for(h = 1;h < (one_after_last - first) / 3;h = 3 * h + 1)
+    ;
+  while(h >= 1)
+  { // for each stride h, use insertion sort
+    for(i = first + h;i < one_after_last;i++)
+    {
+      GT tmp = data[i];
+      for(j = i;j >= first + h && GT_LESS(tmp,data[j - h]);j -= h)
+        data[j] = data[j - h];
+      data[j] = tmp;
+    }
+    h /= 3;
+  }
+}
+
+static inline void GT_NAME(quick_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,j,one_after_small,first_equal,n_smaller,n_larger,n_equal;
+  GT pivot,tmp;
+
+  if(one_after_last - first < 20)
+    GT_NAME(insertion_sort)(data,first,one_after_last);
+  else
+  {
+    //
+    // select pivot (median of three, the pivot's position will be one_after_last-1)
+    //
+#   define POS1  (first)
+#   define POS2  (one_after_last - 1)
+#   define POS3  (first + (one_after_last - first) / 2)
+#   define TEST(pos1,pos2)  do if(GT_LESS(data[pos2],data[pos1]))                               \
+                               { tmp = data[pos1]; data[pos1] = data[pos2]; data[pos2] = tmp; } \
+                               while(0)
+    TEST(POS1,POS2);  // bitonic
+    TEST(POS1,POS3);  // sort of
+    TEST(POS2,POS3);  // 3 items
+#   undef POS1
+#   undef POS2
+#   undef POS3
+#   undef TEST
+    //
+    // 3-way partition (see quick_sort.c)
+    // |first  "smaller part"|one_after_small  "larger part"|first_equal  "equal part"|one_after_last
+    //
+    one_after_small = first;
+    first_equal = one_after_last - 1;
+    pivot = data[first_equal];
+    i = first;
+    while(i < first_equal)
+      if(GT_LESS(data[i],pivot))
+      { // place data[i] in the "smaller than the pivot" part of the array
+        tmp = data[i];
+        data[i] = data[one_after_small];
+        data[one_after_small] = tmp;
+        i++;
+        one_after_small++;
+      }
+      else if(!GT_LESS(pivot,data[i]))
+      { // place data[i] in the "equal to the pivot" part of the array
+        first_equal--;
+        tmp = data[i];
+        data[i] = data[first_equal];
+        data[first_equal] = tmp;
+      }
+      else
+      { // data[i] becomes automatically part of the "larger than the pivot" part of the array
+        i++;
+      }
+    n_smaller = one_after_small - first;
+    n_larger = first_equal - one_after_small;
+    n_equal = one_after_last - first_equal;
+    j = (n_equal < n_larger) ? n_equal : n_larger;
+    for(i = 0;i < j;i++)
+    { // move the "equal to the pivot" part of the array to the middle
+      tmp = data[one_after_small + i];
+      data[one_after_small + i] = data[one_after_last - 1 - i];
+      data[one_after_last - 1 - i] = tmp;
+    }
+    //
+    // recurse
+    //
+    GT_NAME(quick_sort)(data,first,first + n_smaller);
+    GT_NAME(quick_sort)(data,first + n_smaller + n_equal,one_after_last);
+  }
+}
+
+static inline void GT_NAME(merge_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,j,k,middle;
+  GT *buffer;
+
+  if(one_after_last - first < 40)
+    GT_NAME(insertion_sort)(data,first,one_after_last);
+  else
+  {
+    middle = first + (one_after_last - first) / 2;
+    GT_NAME(merge_sort)(data,first,middle);
+    GT_NAME(merge_sort)(data,middle,one_after_last);
+    buffer = (GT *)malloc((size_t)(one_after_last - first) * sizeof(GT)) - first; // no error check!
+    i = first;  // first input (first half)
+    j = middle; // second input (second half)
+    k = first;  // merged output
+    while(k < one_after_last)
+      if(j == one_after_last || (i < middle && !GT_LESS(data[j],data[i])))
+        buffer[k++] = data[i++];
+      else
+        buffer[k++] = data[j++];
+    for(i = first;i < one_after_last;i++)
+      data[i] = buffer[i];
+    free(buffer + first);
+  }
+}
+
+static inline void GT_NAME(heap_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,j,k,n;
+  GT tmp;
+
+  data = data + first - 1;    // adjust pointer (data[first] becomes data[1])
+  n = one_after_last - first; // number of items to sort
+  //
+  // phase 1. heap construction
+  //
+  for(i = n / 2;i >= 1;i--)
+    for(j = i;2 * j <= n;j = k)
+    {
+      k = (2 * j + 1 <= n && GT_LESS(data[2 * j],data[2 * j + 1])) ? 2 * j + 1 : 2 * j;
+      if(!GT_LESS(data[j],data[k]))
+        break;
+      tmp = data[j];
+      data[j] = data[k];
+      data[k] = tmp;
+    }
+  //
+  // phase 2. sort
+  //
+  while(n > 1)
+  {
+    tmp = data[1]; // largest
+    data[1] = data[n];
+    data[n--] = tmp;
+    for(j = 1;2 * j <= n;j = k)
+    {
+      k = (2 * j + 1 <= n && GT_LESS(data[2 * j],data[2 * j + 1])) ? 2 * j + 1 : 2 * j;
+      if(!GT_LESS(data[j],data[k]))
+        break;
+      tmp = data[j];
+      data[j] = data[k];
+      data[k] = tmp;
+    }
+  }
+}
+
+static inline void GT_NAME(rank_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,j,*rank;
+  GT *buffer;
+
+  rank = (GT_INDEX *)malloc((size_t)(one_after_last - first) * sizeof(GT_INDEX)) - first; // no error check!
+  for(i = first;i < one_after_last;i++)
+    rank[i] = first;
+  for(i = first + 1;i < one_after_last;i++)
+    for(j = first;j < i;j++)
+      rank[GT_LESS(data[i],data[j]) ? j : i]++;
+  buffer = (GT *)malloc((size_t)(one_after_last - first) * sizeof(GT)) - first; // no error check!
+  for(i = first;i < one_after_last;i++)
+    buffer[i] = data[i];
+  for(i = first;i < one_after_last;i++)
+    data[rank[i]] = buffer[i];
+  free(buffer + first);
+  free(rank + first);
+}
+
+static inline void GT_NAME(selection_sort)(GT *data,GT_INDEX first,GT_INDEX one_after_last)
+{
+  GT_INDEX i,j,k;
+
+  if(one_after_last - first < 2)
+    return; // nothing to do (and, for an unsigned GT_INDEX, one_after_last - 1 may not be valid)
+  for(i = one_after_last - 1;i > first;i--)
+  {
+    for(j = first,k = first + 1;k <= i;k++) // k starts at first + 1, not at 1 (selection_sort.c reads data[1..first-1])
+      if(GT_LESS(data[j],data[k]))
+        j = k;
+    if(j < i)
+    {
+      GT tmp = data[i];
+      data[i] = data[j];
+      data[j] = tmp;
+    }
+  }
+}
@@ -0,0 +1,115 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// streaming quantile estimation (the P-square algorithm of R. Jain and I. Chlamtac, 1985)
+//
+// use as follows:
+//
+//   quantile_t median;
+//   quantile_init(&median,0.5);
+//   for(...)
+//     quantile_add(&median,x);  // O(1) time, no samples are stored
+//   printf("%.3e\n",quantile_value(&median));
+//
+// Five markers are kept: the minimum, the maximum, the estimate of the p-quantile, and estimates of the p/2 and
+// (1+p)/2 quantiles. After each sample the markers whose positions are off by one or more from their ideal positions
+// are moved, and their heights are adjusted with a piecewise-parabolic formula. With up to five samples the
+// quantile is exact.
+//
+
+#ifndef STREAMING_QUANTILE_H
+#define STREAMING_QUANTILE_H
+
+typedef struct
+{
+  double p;       // the quantile to estimate
+  int count;      // number of samples
+  double q[5];    // heights of the markers
+  double n[5];    // actual positions of the markers (0-based)
+  double np[5];   // ideal positions of the markers
+  double dn[5];   // increments of the ideal positions
+}
+quantile_t;
+
+static void quantile_init(quantile_t *e,double p)
+{
+  e->p = p;
+  e->count = 0;
+  e->dn[0] = 0.0;
+  e->dn[1] = p / 2.0;
+  e->dn[2] = p;
+  e->dn[3] = (1.0 + p) / 2.0;
+  e->dn[4] = 1.0;
+}
+
+static void quantile_add(quantile_t *e,double x)
+{
+  int i,j,k;
+  double d,s,qp;
+
+  if(e->count < 5)
+  { // the first five samples are kept, sorted
+    for(j = e->count++;j > 0 && e->q[j - 1] > x;j--)
+      e->q[j] = e->q[j - 1];
+    e->q[j] = x;
+    if(e->count == 5)
+      for(i = 0;i < 5;i++)
+      {
+        e->n[i] = (double)i;
+        e->np[i] = 4.0 * e->dn[i];
+      }
+    return;
+  }
+  //
+  // the cell of x (the extreme markers are updated if x is a new minimum or maximum)
+  //
+  if(x < e->q[0])
+  {
+    e->q[0] = x;
+    k = 0;
+  }
+  else if(x >= e->q[4])
+  {
+    e->q[4] = x;
+    k = 3;
+  }
+  else
+    for(k = 0;x >= e->q[k + 1];k++)
+      ;
+  for(i = k + 1;i < 5;i++)
+    e->n[i] += 1.0;
+  for(i = 0;i < 5;i++)
+    e->np[i] += e->dn[i];
+  e->count++;
+  //
+  // adjust the heights of the three middle markers
+  //
+  for(i = 1;i <= 3;i++)
+  {
+    d = e->np[i] - e->n[i];
+    if((d >= 1.0 && e->n[i + 1] - e->n[i] > 1.0) || (d <= -1.0 && e->n[i - 1] - e->n[i] < -1.0))
+    {
+      s = (d >= 0.0) ? 1.0 : -1.0;
+      qp = e->q[i] + s / (e->n[i + 1] - e->n[i - 1]) * ((e->n[i] - e->n[i - 1] + s) * (e->q[i + 1] - e->q[i]) / (e->n[i + 1] - e->n[i]) +
+                                                       (e->n[i + 1] - e->n[i] - s) * (e->q[i] - e->q[i - 1]) / (e->n[i] - e->n[i - 1]));
+      if(!(e->q[i - 1] < qp && qp < e->q[i + 1]))
+      { // parabolic prediction out of order, use a linear one
+        j = i + (int)s;
+        qp = e->q[i] + s * (e->q[j] - e->q[i]) / (e->n[j] - e->n[i]);
+      }
+      e->q[i] = qp;
+      e->n[i] += s;
+    }
+  }
+}
+
+static double quantile_value(quantile_t *e)
+{
+  if(e->count == 0)
+    return 0.0;
+  if(e->count <= 5)
+    return e->q[(int)(e->p * (double)(e->count - 1) + 0.5)]; // exact (the markers are still the sorted samples)
+  return e->q[2];
+}
+
+#endif
@@ -0,0 +1,191 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// strings for the tests and measurements of the string sorting routines (see the str instance in sorting_methods.c)
+//
+// random_string() returns a random string of the kind chosen by set_string_generator():
+//   urls   https://host/path?query, with a few hosts and a small vocabulary of path segments (long common prefixes)
+//   paths  /home/user/dir/.../file.ext, with a few users and a small vocabulary of directories (idem)
+//   words  1 to 20 random lower case letters (short common prefixes)
+//   keys   tenantNN:userNNNNNN:XXXXXXXX, database-like keys (common prefixes of fixed length)
+// string_of_int(v) returns a string that is placed, by strcmp(), in the same order as the integer v: an url whose path
+// has one segment for each of the six base 16 digits of v (v < 2^24; the segments are sorted, and none is a prefix of another,
+// so the order is kept); this is how the input distributions of input_distributions.c become strings. Both never
+// return an empty string, which is reserved for string_of_int(-1).
+//
+// The strings are stored in a list of large chunks of memory; strings_reset() forgets all strings, and their memory
+// is reused by the next ones, so generating the data for each measurement does not allocate memory (after the first).
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sorting_methods.h"
+
+#define CHUNK_SIZE   (1 << 20)  // bytes per chunk
+#define MAX_LENGTH   255        // longest generated string
+
+typedef struct chunk_s
+{
+  struct chunk_s *next;
+  char data[CHUNK_SIZE];
+}
+chunk_t;
+
+static chunk_t *first_chunk = NULL;   // list of chunks
+static chunk_t *current_chunk = NULL; // chunk in use (NULL before the first string)
+static size_t used = 0;               // bytes used in the current chunk
+
+static char *store(char *s)
+{
+  size_t size;
+  chunk_t *c;
+
+  size = strlen(s) + 1;
+  if(current_chunk == NULL || used + size > (size_t)CHUNK_SIZE)
+  {
+    c = (current_chunk == NULL) ? first_chunk : current_chunk->next; // reuse the chunks used before strings_reset()
+    if(c == NULL)
+    {
+      if((c = (chunk_t *)malloc(sizeof(chunk_t))) == NULL)
+      {
+        fprintf(stderr,"unable to allocate memory for the strings --- 😒\n");
+        exit(1);
+      }
+      c->next = NULL;
+      if(current_chunk == NULL)
+        first_chunk = c;
+      else
+        current_chunk->next = c;
+    }
+    current_chunk = c;
+    used = 0;
+  }
+  memcpy(&current_chunk->data[used],s,size);
+  used += size;
+  return &current_chunk->data[used - size];
+}
+
+void strings_reset(void)
+{
+  current_chunk = NULL;
+  used = 0;
+}
+
+//
+// the generators (they use rand(), so the strings depend on srand())
+//
+
+static char *hosts[] = { "www.example.com","en.wikipedia.org","github.com","www.ua.pt","news.ycombinator.com","stackoverflow.com","www.youtube.com","docs.python.org" };
+static char *users[] = { "alice","bob","carol","dave" };
+static char *segments[16] =
+{ // sorted, and none is a prefix of another (see string_of_int())
+  "about","articles","blog","category","docs","download","images","index","news","products","questions","search","static","user","view","wiki"
+};
+static char *extensions[] = { ".c",".h",".txt",".pdf",".jpg",".html" };
+#define PICK(table)  table[rand() % (int)(sizeof(table) / sizeof(table[0]))]
+
+static int random_letters(char *s,int min_length,int max_length)
+{
+  int i,length;
+
+  length = min_length + rand() % (max_length - min_length + 1);
+  for(i = 0;i < length;i++)
+    s[i] = (char)('a' + rand() % 26);
+  s[length] = '\0';
+  return length;
+}
+
+static void url(char *s)
+{
+  int k,length;
+
+  length = sprintf(s,"https://%s",PICK(hosts));
+  for(k = 1 + rand() % 4;k > 0;k--)
+  {
+    s[length++] = '/';
+    if(rand() % 4 == 0)
+      length += random_letters(&s[length],3,10);
+    else
+      length += sprintf(&s[length],"%s",PICK(segments));
+  }
+  if(rand() % 2 == 0)
+    sprintf(&s[length],"?id=%d",rand() % 100000);
+}
+
+static void path(char *s)
+{
+  int k,length;
+
+  length = sprintf(s,"/home/%s",PICK(users));
+  for(k = rand() % 6;k > 0;k--)
+    length += sprintf(&s[length],"/%s",PICK(segments));
+  s[length++] = '/';
+  length += random_letters(&s[length],1,12);
+  sprintf(&s[length],"%s",PICK(extensions));
+}
+
+static void word(char *s)
+{
+  (void)random_letters(s,1,20);
+}
+
+static void key(char *s)
+{
+  sprintf(s,"tenant%02d:user%06d:%08x",rand() % 16,rand() % 1000000,(unsigned int)rand());
+}
+
+static struct
+{
+  void (*function)(char *s);
+  char *name;
+}
+generators[] =
+{
+  { url,   "urls"  },
+  { path,  "paths" },
+  { word,  "words" },
+  { key,   "keys"  }
+};
+static int generator = 0; // urls
+
+int n_string_generators = (int)(sizeof(generators) / sizeof(generators[0]));
+
+char *string_generator_name(int i)
+{
+  return generators[i].name;
+}
+
+int set_string_generator(char *name)
+{
+  int i;
+
+  for(i = 0;i < n_string_generators;i++)
+    if(strcmp(name,generators[i].name) == 0)
+    {
+      generator = i;
+      return 1;
+    }
+  return 0;
+}
+
+char *random_string(void)
+{
+  char s[MAX_LENGTH + 1];
+
+  (*generators[generator].function)(s);
+  return store(s);
+}
+
+char *string_of_int(int v)
+{
+  char s[MAX_LENGTH + 1];
+  int d,length;
+
+  if(v < 0)
+    return ""; // -1
+  length = sprintf(s,"https://www.example.com");
+  for(d = 20;d >= 0;d -= 4)
+    length += sprintf(&s[length],"/%s",segments[(v >> d) & 15]);
+  return store(s);
+}
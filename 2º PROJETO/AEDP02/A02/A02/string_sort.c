@@ -0,0 +1,260 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// string sorting (the strings are ordered as by strcmp(), that is, by their unsigned chars)
+//
+// A comparison sort of strings pays twice: each strcmp() starts at the first character, so the common prefixes of
+// the strings (long ones in URLs, file paths, or database keys) are compared again and again, and each comparison
+// follows two pointers to memory that is most likely not in the caches. The routines of this file use each
+// character of a common prefix only a few times:
+//   * multikey_quick_sort() (J. Bentley and R. Sedgewick, 1997) is a quick sort of the characters at position depth;
+//     the "equal" part of a partition is sorted by the characters at position depth+1
+//   * msd_radix_sort() (in the style of J. Kärkkäinen and T. Rantala, 2008) distributes the strings into 256 buckets
+//     according to the character at position depth, and then sorts each bucket by the next character; the
+//     characters at position depth are first copied, in one pass, to a character cache, so that each string is
+//     visited only once per level (the counting pass and the distribution pass read the cache)
+//   * lcp_merge_sort() (W. Ng and K. Kakehi, 2008) is a merge sort that also computes the longest common prefix
+//     (lcp) of each string and its predecessor; when two strings are compared during a merge the length of their
+//     common prefix is usually known, so the comparison starts after it, and often it is not needed at all
+// Small ranges are sorted by an insertion sort that skips the depth characters known to be equal.
+//
+
+#include <stdlib.h>
+#include <string.h>
+#include "sorting_methods.h"
+
+#define INSERTION_SORT_LIMIT  20  // ranges smaller than this are sorted by insertion sort
+
+#define CHAR(s,d)  ((unsigned char)(s)[d])
+#define SWAP(i,j)  do { char *tmp_ = data[i]; data[i] = data[j]; data[j] = tmp_; } while(0)
+
+//
+// insertion sort of strings whose first depth characters are equal
+//
+static void string_insertion_sort(char **data,int first,int one_after_last,int depth)
+{
+  int i,j;
+  char *tmp;
+
+  for(i = first + 1;i < one_after_last;i++)
+  {
+    tmp = data[i];
+    for(j = i;j > first && strcmp(tmp + depth,data[j - 1] + depth) < 0;j--)
+      data[j] = data[j - 1];
+    data[j] = tmp;
+  }
+}
+
+//
+// multikey quick sort
+//
+
+static void mkqs(char **data,int first,int one_after_last,int depth)
+{
+  int lt,i,gt,a,b,c;
+  unsigned char pivot;
+
+  while(one_after_last - first >= INSERTION_SORT_LIMIT)
+  {
+    //
+    // the pivot is the median of three characters
+    //
+    a = CHAR(data[first],depth);
+    b = CHAR(data[first + (one_after_last - first) / 2],depth);
+    c = CHAR(data[one_after_last - 1],depth);
+    pivot = (unsigned char)((a < b) ? ((b < c) ? b : (a < c) ? c : a) : ((a < c) ? a : (b < c) ? c : b));
+    //
+    // 3-way partition (E. W. Dijkstra); at the end of the while loop the strings will be partitioned as follows:
+    // |first  "smaller character"|lt  "equal character"|gt+1  "larger character"|one_after_last
+    //
+    lt = i = first;
+    gt = one_after_last - 1;
+    while(i <= gt)
+      if(CHAR(data[i],depth) < pivot)
+      {
+        SWAP(lt,i);
+        lt++;
+        i++;
+      }
+      else if(CHAR(data[i],depth) > pivot)
+      {
+        SWAP(i,gt);
+        gt--;
+      }
+      else
+        i++;
+    mkqs(data,first,lt,depth);
+    mkqs(data,gt + 1,one_after_last,depth);
+    if(pivot == 0)
+      return; // the "equal" strings have ended, so they are equal
+    first = lt; // sort the "equal" part by the next character (iteratively)
+    one_after_last = gt + 1;
+    depth++;
+  }
+  string_insertion_sort(data,first,one_after_last,depth);
+}
+
+void multikey_quick_sort(char **data,int first,int one_after_last)
+{
+  mkqs(data,first,one_after_last,0);
+}
+
+//
+// MSD radix sort
+//
+
+static void msd(char **data,int first,int one_after_last,int depth,char **buffer,unsigned char *cache)
+{
+  int i,c,n,count[256],start[256];
+
+  n = one_after_last - first;
+  for(;;)
+  {
+    if(n < INSERTION_SORT_LIMIT)
+    {
+      string_insertion_sort(data,first,one_after_last,depth);
+      return;
+    }
+    memset(count,0,sizeof(count));
+    for(i = 0;i < n;i++)
+      count[cache[i] = CHAR(data[first + i],depth)]++;
+    if(count[cache[0]] < n)
+      break;
+    if(cache[0] == 0)
+      return; // all strings have ended, so they are equal
+    depth++;  // all strings have the same character at position depth (a common prefix), no need to move them
+  }
+  for(c = 0,start[0] = 0;c < 255;c++)
+    start[c + 1] = start[c] + count[c];
+  for(i = 0;i < n;i++)
+    buffer[start[cache[i]]++] = data[first + i];
+  memcpy(&data[first],buffer,(size_t)n * sizeof(char *));
+  //
+  // now start[c] is the index of the first string of bucket c+1; bucket 0 (the strings that have ended) is done
+  //
+  for(c = 1;c < 256;c++)
+    if(count[c] > 1)
+      msd(data,first + start[c] - count[c],first + start[c],depth + 1,buffer,cache);
+}
+
+void msd_radix_sort(char **data,int first,int one_after_last)
+{
+  unsigned char *cache;
+  char **buffer;
+  int n;
+
+  n = one_after_last - first;
+  if(n < 2)
+    return;
+  buffer = (char **)malloc((size_t)n * sizeof(char *));
+  cache = (unsigned char *)malloc((size_t)n);
+  if(buffer == NULL || cache == NULL)
+    multikey_quick_sort(data,first,one_after_last); // not enough memory
+  else
+    msd(data,first,one_after_last,0,buffer,cache);
+  free(cache);
+  free(buffer);
+}
+
+//
+// LCP merge sort; lcp[i] is the length of the longest common prefix of data[i-1] and data[i] (lcp[0] is not used)
+//
+
+static int lcp_compare(char *a,char *b,int h,int *lcp_p)
+{ // compare a and b, known to have a common prefix of length h; returns a <= b, and *lcp_p is their lcp
+  while(a[h] != '\0' && a[h] == b[h])
+    h++;
+  *lcp_p = h;
+  return CHAR(a,h) <= CHAR(b,h);
+}
+
+static void lcp_msort(char **data,int *lcp,int n,char **buffer,int *buffer_lcp)
+{
+  int i,j,k,h,n_a,h_a,h_b;
+
+  if(n < INSERTION_SORT_LIMIT)
+  {
+    string_insertion_sort(data,0,n,0);
+    for(i = 1;i < n;i++)
+      (void)lcp_compare(data[i - 1],data[i],0,&lcp[i]);
+    return;
+  }
+  n_a = n / 2;
+  lcp_msort(data,lcp,n_a,buffer,buffer_lcp);
+  lcp_msort(data + n_a,lcp + n_a,n - n_a,buffer,buffer_lcp);
+  if(strcmp(data[n_a - 1],data[n_a]) <= 0)
+  { // already in order (the lcp of the two middle strings is still needed)
+    (void)lcp_compare(data[n_a - 1],data[n_a],0,&lcp[n_a]);
+    return;
+  }
+  //
+  // merge the first half (copied to the buffer) with the second half; h_a (h_b) is the lcp of the current string of
+  // the first (second) half and the last string that was output (both are 0 at the start)
+  //
+  memcpy(buffer,data,(size_t)n_a * sizeof(char *));
+  memcpy(buffer_lcp,lcp,(size_t)n_a * sizeof(int));
+  i = 0;
+  j = n_a;
+  k = 0;
+  h_a = h_b = 0;
+  while(i < n_a && j < n)
+    if(h_a > h_b)
+    { // buffer[i] agrees with the last output for longer than data[j], so it is smaller
+      data[k] = buffer[i];
+      lcp[k++] = h_a;
+      if(++i < n_a)
+        h_a = buffer_lcp[i];
+    }
+    else if(h_a < h_b)
+    { // and vice versa (k < j, so lcp[j+1] has not been overwritten)
+      data[k] = data[j];
+      lcp[k++] = h_b;
+      if(++j < n)
+        h_b = lcp[j];
+    }
+    else if(lcp_compare(buffer[i],data[j],h_a,&h) != 0)
+    { // equal lcps, buffer[i] <= data[j] (ties go to the first half, so the sort is stable)
+      data[k] = buffer[i];
+      lcp[k++] = h_a;
+      h_b = h;
+      if(++i < n_a)
+        h_a = buffer_lcp[i];
+    }
+    else
+    { // equal lcps, buffer[i] > data[j]
+      data[k] = data[j];
+      lcp[k++] = h_b;
+      h_a = h;
+      if(++j < n)
+        h_b = lcp[j];
+    }
+  while(i < n_a)
+  { // the rest of the first half (the rest of the second half is already in place)
+    data[k] = buffer[i];
+    lcp[k++] = h_a;
+    if(++i < n_a)
+      h_a = buffer_lcp[i];
+  }
+  if(j < n)
+    lcp[j] = h_b;
+}
+
+void lcp_merge_sort(char **data,int first,int one_after_last)
+{
+  int n,*lcp,*buffer_lcp;
+  char **buffer;
+
+  n = one_after_last - first;
+  if(n < 2)
+    return;
+  lcp = (int *)malloc((size_t)n * sizeof(int));
+  buffer = (char **)malloc((size_t)(n / 2) * sizeof(char *));
+  buffer_lcp = (int *)malloc((size_t)(n / 2) * sizeof(int));
+  if(lcp == NULL || buffer == NULL || buffer_lcp == NULL)
+    multikey_quick_sort(data,first,one_after_last); // not enough memory
+  else
+    lcp_msort(data + first,lcp,n,buffer,buffer_lcp);
+  free(buffer_lcp);
+  free(buffer);
+  free(lcp);
+}
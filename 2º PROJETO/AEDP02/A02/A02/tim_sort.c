@@ -0,0 +1,19 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// natural (run-adaptive) stable merge sort, in the style of Tim Peters' timsort (see tim_sort_template.h)
+//
+
+#include "sorting_methods.h"
+
+#define GT            T
+#define GT_SUFFIX     int
+#define GT_LESS(a,b)  ((a) < (b))
+#include "sorting_methods_template.h"
+#include "block_merge_sort_template.h"
+#include "tim_sort_template.h"
+
+void tim_sort(T *data,int first,int one_after_last)
+{
+  tim_sort_int(data,first,one_after_last);
+}
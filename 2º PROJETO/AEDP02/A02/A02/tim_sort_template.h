@@ -0,0 +1,507 @@
+//
+// Tomás Oliveira e Silva, AED, December 2020
+//
+// type-generic natural (run-adaptive) stable merge sort, in the style of Tim Peters' timsort
+//
+// Like radix_sort_template.h, this file is a "template"; it has to be included after sorting_methods_template.h and
+// block_merge_sort_template.h, with the same GT and GT_SUFFIX. The indices are ints (GT_INDEX must be int).
+//
+// The array is split into runs: maximal non-decreasing sequences, or strictly decreasing ones (which are reversed,
+// without breaking stability). Runs shorter than min_run (a number between 32 and 64) are extended with binary
+// insertion sort. The runs are pushed onto a stack whose lengths obey (after merge_collapse())
+//   len[i-2] > len[i-1] + len[i]  and  len[i-1] > len[i]
+// where the first condition is also checked one level deeper (the fix of de Gouw et al., 2015, without which the
+// invariant can be broken and the stack can overflow). This keeps the merges balanced and the stack small.
+//
+// Merges first skip the items that are already in place (galloping searches), copy the shorter run to a buffer, and
+// then merge in the usual way until one of the runs "wins" min_gallop times in a row; then they switch to galloping
+// mode (exponential search followed by binary search, and a block copy) until that is no longer profitable. So,
+// already sorted (or reversed) data takes O(n) time, and data made of a few sorted pieces takes O(n log(pieces)).
+//
+// If there is no memory for the buffer (half of the items), the array is sorted by block_merge_sort(), which is also
+// stable.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TS_MIN_MERGE          64  // arrays smaller than this are sorted by binary insertion sort
+#define TS_MIN_GALLOP          7  // initial value of min_gallop
+#define TS_MAX_PENDING_RUNS   85  // enough for 2^64 items (the run lengths grow at least like the Fibonacci numbers)
+
+typedef struct
+{
+  GT *data;                           // data to be sorted
+  GT *buffer;                         // room for half of the items
+  int min_gallop;                     // the threshold to enter galloping mode (adapts to the data)
+  int n_runs;                         // number of pending runs
+  int run_base[TS_MAX_PENDING_RUNS];  // the pending runs (the run i is data[run_base[i]..run_base[i]+run_len[i]-1])
+  int run_len[TS_MAX_PENDING_RUNS];
+}
+GT_NAME(ts_state);
+
+
+//
+// runs
+//
+
+static inline void GT_NAME(ts_binary_insertion_sort)(GT *data,int first,int one_after_last,int start)
+{ // data[first..start-1] is already sorted
+  int left,right,middle;
+  GT pivot;
+
+  for(;start < one_after_last;start++)
+  {
+    pivot = data[start];
+    left = first;
+    right = start;
+    while(left < right)
+    { // place the pivot after the items equal to it (stable)
+      middle = left + (right - left) / 2;
+      if(GT_LESS(pivot,data[middle]))
+        right = middle;
+      else
+        left = middle + 1;
+    }
+    memmove(&data[left + 1],&data[left],(size_t)(start - left) * sizeof(GT));
+    data[left] = pivot;
+  }
+}
+
+static inline int GT_NAME(ts_count_run)(GT *data,int first,int one_after_last)
+{ // length of the run that starts at data[first] (a strictly decreasing run is reversed)
+  int i,j,k;
+  GT tmp;
+
+  i = first + 1;
+  if(i == one_after_last)
+    return 1;
+  if(GT_LESS(data[first + 1],data[first]))
+  {
+    i++;
+    while(i < one_after_last && GT_LESS(data[i],data[i - 1]))
+      i++;
+    for(j = first,k = i - 1;j < k;j++,k--)
+    {
+      tmp = data[j];
+      data[j] = data[k];
+      data[k] = tmp;
+    }
+  }
+  else
+  {
+    i++;
+    while(i < one_after_last && !GT_LESS(data[i],data[i - 1]))
+      i++;
+  }
+  return i - first;
+}
+
+
+//
+// galloping searches in a[0..n-1] (sorted), starting at a[hint]
+//   gallop_left() returns k such that a[k-1] < key <= a[k] (where key would be inserted before the equal items)
+//   gallop_right() returns k such that a[k-1] <= key < a[k] (where key would be inserted after the equal items)
+//
+
+static inline int GT_NAME(ts_gallop_left)(GT key,GT *a,int n,int hint)
+{
+  int last_ofs,ofs,max_ofs,tmp,middle;
+
+  last_ofs = 0;
+  ofs = 1;
+  if(GT_LESS(a[hint],key))
+  { // gallop to the right until a[hint+last_ofs] < key <= a[hint+ofs]
+    max_ofs = n - hint;
+    while(ofs < max_ofs && GT_LESS(a[hint + ofs],key))
+    {
+      last_ofs = ofs;
+      ofs = 2 * ofs + 1;
+    }
+    if(ofs > max_ofs)
+      ofs = max_ofs;
+    last_ofs += hint;
+    ofs += hint;
+  }
+  else
+  { // gallop to the left until a[hint-ofs] < key <= a[hint-last_ofs]
+    max_ofs = hint + 1;
+    while(ofs < max_ofs && !GT_LESS(a[hint - ofs],key))
+    {
+      last_ofs = ofs;
+      ofs = 2 * ofs + 1;
+    }
+    if(ofs > max_ofs)
+      ofs = max_ofs;
+    tmp = last_ofs;
+    last_ofs = hint - ofs;
+    ofs = hint - tmp;
+  }
+  for(last_ofs++;last_ofs < ofs;) // now a[last_ofs-1] < key <= a[ofs]; binary search
+  {
+    middle = last_ofs + (ofs - last_ofs) / 2;
+    if(GT_LESS(a[middle],key))
+      last_ofs = middle + 1;
+    else
+      ofs = middle;
+  }
+  return ofs;
+}
+
+static inline int GT_NAME(ts_gallop_right)(GT key,GT *a,int n,int hint)
+{
+  int last_ofs,ofs,max_ofs,tmp,middle;
+
+  last_ofs = 0;
+  ofs = 1;
+  if(GT_LESS(key,a[hint]))
+  { // gallop to the left until a[hint-ofs] <= key < a[hint-last_ofs]
+    max_ofs = hint + 1;
+    while(ofs < max_ofs && GT_LESS(key,a[hint - ofs]))
+    {
+      last_ofs = ofs;
+      ofs = 2 * ofs + 1;
+    }
+    if(ofs > max_ofs)
+      ofs = max_ofs;
+    tmp = last_ofs;
+    last_ofs = hint - ofs;
+    ofs = hint - tmp;
+  }
+  else
+  { // gallop to the right until a[hint+last_ofs] <= key < a[hint+ofs]
+    max_ofs = n - hint;
+    while(ofs < max_ofs && !GT_LESS(key,a[hint + ofs]))
+    {
+      last_ofs = ofs;
+      ofs = 2 * ofs + 1;
+    }
+    if(ofs > max_ofs)
+      ofs = max_ofs;
+    last_ofs += hint;
+    ofs += hint;
+  }
+  for(last_ofs++;last_ofs < ofs;) // now a[last_ofs-1] <= key < a[ofs]; binary search
+  {
+    middle = last_ofs + (ofs - last_ofs) / 2;
+    if(GT_LESS(key,a[middle]))
+      ofs = middle;
+    else
+      last_ofs = middle + 1;
+  }
+  return ofs;
+}
+
+
+//
+// merges of adjacent runs; on entry the first item of the second run is smaller than the first item of the first run,
+// and the last item of the first run is larger than all items of the second run
+//
+
+# define MOVE(dst,src,n)  memmove((dst),(src),(size_t)(n) * sizeof(GT))
+
+static inline void GT_NAME(ts_merge_low)(GT_NAME(ts_state) *s,int base1,int len1,int base2,int len2)
+{ // len1 <= len2; the first run is copied to the buffer and the merge proceeds from left to right
+  int cursor1,cursor2,dest,count1,count2,min_gallop;
+  GT *a = s->data,*tmp = s->buffer;
+
+  MOVE(tmp,&a[base1],len1);
+  cursor1 = 0;     // in tmp
+  cursor2 = base2; // in a
+  dest = base1;
+  a[dest++] = a[cursor2++];
+  if(--len2 == 0)
+  {
+    MOVE(&a[dest],&tmp[cursor1],len1);
+    return;
+  }
+  if(len1 == 1)
+  {
+    MOVE(&a[dest],&a[cursor2],len2);
+    a[dest + len2] = tmp[cursor1];
+    return;
+  }
+  min_gallop = s->min_gallop;
+  for(;;)
+  {
+    //
+    // one item at a time, until one run wins min_gallop times in a row
+    //
+    count1 = count2 = 0;
+    do
+      if(GT_LESS(a[cursor2],tmp[cursor1]))
+      {
+        a[dest++] = a[cursor2++];
+        count2++;
+        count1 = 0;
+        if(--len2 == 0)
+          goto done;
+      }
+      else
+      {
+        a[dest++] = tmp[cursor1++];
+        count1++;
+        count2 = 0;
+        if(--len1 == 1)
+          goto done;
+      }
+    while((count1 | count2) < min_gallop);
+    //
+    // galloping mode
+    //
+    do
+    {
+      count1 = GT_NAME(ts_gallop_right)(a[cursor2],&tmp[cursor1],len1,0);
+      if(count1 != 0)
+      {
+        MOVE(&a[dest],&tmp[cursor1],count1);
+        dest += count1;
+        cursor1 += count1;
+        len1 -= count1;
+        if(len1 <= 1)
+          goto done;
+      }
+      a[dest++] = a[cursor2++];
+      if(--len2 == 0)
+        goto done;
+      count2 = GT_NAME(ts_gallop_left)(tmp[cursor1],&a[cursor2],len2,0);
+      if(count2 != 0)
+      {
+        MOVE(&a[dest],&a[cursor2],count2);
+        dest += count2;
+        cursor2 += count2;
+        len2 -= count2;
+        if(len2 == 0)
+          goto done;
+      }
+      a[dest++] = tmp[cursor1++];
+      if(--len1 == 1)
+        goto done;
+      min_gallop--;
+    }
+    while(count1 >= TS_MIN_GALLOP || count2 >= TS_MIN_GALLOP);
+    if(min_gallop < 0)
+      min_gallop = 0;
+    min_gallop += 2; // penalize leaving galloping mode
+  }
+done:
+  s->min_gallop = (min_gallop < 1) ? 1 : min_gallop;
+  if(len1 == 1)
+  { // the last item of the first run goes to the end
+    MOVE(&a[dest],&a[cursor2],len2);
+    a[dest + len2] = tmp[cursor1];
+  }
+  else
+    MOVE(&a[dest],&tmp[cursor1],len1); // the second run is exhausted (len1 == 0 is not possible)
+}
+
+static inline void GT_NAME(ts_merge_high)(GT_NAME(ts_state) *s,int base1,int len1,int base2,int len2)
+{ // len1 > len2; the second run is copied to the buffer and the merge proceeds from right to left
+  int cursor1,cursor2,dest,count1,count2,min_gallop;
+  GT *a = s->data,*tmp = s->buffer;
+
+  MOVE(tmp,&a[base2],len2);
+  cursor1 = base1 + len1 - 1; // in a
+  cursor2 = len2 - 1;         // in tmp
+  dest = base2 + len2 - 1;
+  a[dest--] = a[cursor1--];
+  if(--len1 == 0)
+  {
+    MOVE(&a[dest - (len2 - 1)],tmp,len2);
+    return;
+  }
+  if(len2 == 1)
+  {
+    dest -= len1;
+    cursor1 -= len1;
+    MOVE(&a[dest + 1],&a[cursor1 + 1],len1);
+    a[dest] = tmp[cursor2];
+    return;
+  }
+  min_gallop = s->min_gallop;
+  for(;;)
+  {
+    //
+    // one item at a time, until one run wins min_gallop times in a row
+    //
+    count1 = count2 = 0;
+    do
+      if(GT_LESS(tmp[cursor2],a[cursor1]))
+      {
+        a[dest--] = a[cursor1--];
+        count1++;
+        count2 = 0;
+        if(--len1 == 0)
+          goto done;
+      }
+      else
+      {
+        a[dest--] = tmp[cursor2--];
+        count2++;
+        count1 = 0;
+        if(--len2 == 1)
+          goto done;
+      }
+    while((count1 | count2) < min_gallop);
+    //
+    // galloping mode
+    //
+    do
+    {
+      count1 = len1 - GT_NAME(ts_gallop_right)(tmp[cursor2],&a[base1],len1,len1 - 1);
+      if(count1 != 0)
+      {
+        dest -= count1;
+        cursor1 -= count1;
+        len1 -= count1;
+        MOVE(&a[dest + 1],&a[cursor1 + 1],count1);
+        if(len1 == 0)
+          goto done;
+      }
+      a[dest--] = tmp[cursor2--];
+      if(--len2 == 1)
+        goto done;
+      count2 = len2 - GT_NAME(ts_gallop_left)(a[cursor1],tmp,len2,len2 - 1);
+      if(count2 != 0)
+      {
+        dest -= count2;
+        cursor2 -= count2;
+        len2 -= count2;
+        MOVE(&a[dest + 1],&tmp[cursor2 + 1],count2);
+        if(len2 <= 1)
+          goto done;
+      }
+      a[dest--] = a[cursor1--];
+      if(--len1 == 0)
+        goto done;
+      min_gallop--;
+    }
+    while(count1 >= TS_MIN_GALLOP || count2 >= TS_MIN_GALLOP);
+    if(min_gallop < 0)
+      min_gallop = 0;
+    min_gallop += 2; // penalize leaving galloping mode
+  }
+done:
+  s->min_gallop = (min_gallop < 1) ? 1 : min_gallop;
+  if(len2 == 1)
+  { // the first item of the second run goes to the beginning
+    dest -= len1;
+    cursor1 -= len1;
+    MOVE(&a[dest + 1],&a[cursor1 + 1],len1);
+    a[dest] = tmp[cursor2];
+  }
+  else
+    MOVE(&a[dest - (len2 - 1)],tmp,len2); // the first run is exhausted (len2 == 0 is not possible)
+}
+
+# undef MOVE
+
+static inline void GT_NAME(ts_merge_at)(GT_NAME(ts_state) *s,int i)
+{ // merge the runs i and i+1 (i is either the second or the third run from the top of the stack)
+  int base1,len1,base2,len2,k;
+  GT *a = s->data;
+
+  base1 = s->run_base[i];
+  len1 = s->run_len[i];
+  base2 = s->run_base[i + 1];
+  len2 = s->run_len[i + 1];
+  s->run_len[i] = len1 + len2;
+  if(i == s->n_runs - 3)
+  {
+    s->run_base[i + 1] = s->run_base[i + 2];
+    s->run_len[i + 1] = s->run_len[i + 2];
+  }
+  s->n_runs--;
+  k = GT_NAME(ts_gallop_right)(a[base2],&a[base1],len1,0); // the items of the first run that are already in place
+  base1 += k;
+  len1 -= k;
+  if(len1 == 0)
+    return;
+  len2 = GT_NAME(ts_gallop_left)(a[base1 + len1 - 1],&a[base2],len2,len2 - 1); // the same for the second run
+  if(len2 == 0)
+    return;
+  if(len1 <= len2)
+    GT_NAME(ts_merge_low)(s,base1,len1,base2,len2);
+  else
+    GT_NAME(ts_merge_high)(s,base1,len1,base2,len2);
+}
+
+static inline void GT_NAME(ts_merge_collapse)(GT_NAME(ts_state) *s)
+{ // restore the stack invariants
+  int n,*len = s->run_len;
+
+  while(s->n_runs > 1)
+  {
+    n = s->n_runs - 2;
+    if((n > 0 && len[n - 1] <= len[n] + len[n + 1]) || (n > 1 && len[n - 2] <= len[n - 1] + len[n]))
+    {
+      if(len[n - 1] < len[n + 1])
+        n--;
+    }
+    else if(len[n] > len[n + 1])
+      break;
+    GT_NAME(ts_merge_at)(s,n);
+  }
+}
+
+static inline void GT_NAME(ts_merge_force_collapse)(GT_NAME(ts_state) *s)
+{ // merge all runs
+  int n;
+
+  while(s->n_runs > 1)
+  {
+    n = s->n_runs - 2;
+    if(n > 0 && s->run_len[n - 1] < s->run_len[n + 1])
+      n--;
+    GT_NAME(ts_merge_at)(s,n);
+  }
+}
+
+
+static inline void GT_NAME(tim_sort)(GT *data,int first,int one_after_last)
+{
+  GT_NAME(ts_state) s;
+  int n,r,min_run,run_len,force;
+
+  n = one_after_last - first;
+  if(n < 2)
+    return;
+  if(n < TS_MIN_MERGE)
+  { // a "mini" timsort, no merges
+    r = GT_NAME(ts_count_run)(data,first,one_after_last);
+    GT_NAME(ts_binary_insertion_sort)(data,first,one_after_last,first + r);
+    return;
+  }
+  s.data = data;
+  s.buffer = (GT *)malloc((size_t)(n / 2) * sizeof(GT));
+  if(s.buffer == NULL)
+  { // not enough memory for the buffer, use a stable sort that needs much less (or none)
+    GT_NAME(block_merge_sort)(data,first,one_after_last);
+    return;
+  }
+  s.min_gallop = TS_MIN_GALLOP;
+  s.n_runs = 0;
+  for(r = 0,min_run = n;min_run >= TS_MIN_MERGE;min_run >>= 1)
+    r |= min_run & 1;
+  min_run += r; // n/min_run is a power of two, or a bit smaller than one (so the final merges are balanced)
+  while(first < one_after_last)
+  {
+    run_len = GT_NAME(ts_count_run)(data,first,one_after_last);
+    if(run_len < min_run)
+    { // extend the run
+      force = (one_after_last - first < min_run) ? one_after_last - first : min_run;
+      GT_NAME(ts_binary_insertion_sort)(data,first,first + force,first + run_len);
+      run_len = force;
+    }
+    s.run_base[s.n_runs] = first;
+    s.run_len[s.n_runs++] = run_len;
+    GT_NAME(ts_merge_collapse)(&s);
+    first += run_len;
+  }
+  GT_NAME(ts_merge_force_collapse)(&s);
+  free(s.buffer);
+}
+
+#undef TS_MIN_MERGE
+#undef TS_MIN_GALLOP
+#undef TS_MAX_PENDING_RUNS
@@ -10,6 +10,9 @@
 //   double t2 = cpu_time();
 //   printf("elapsed time: %.6f seconds\n",t2 - t1);
 //
+// cpu_time() measures the cpu time of the process (the sum of the cpu times of all its threads); to measure the
+// wall-clock time (for example, of multithreaded code) use wall_time() in the same way
+//
 
 
 #if defined(__linux__) || defined(__APPLE__)
@@ -29,6 +32,15 @@ double cpu_time(void)
   return (double)current_time.tv_sec + 1.0e-9 * (double)current_time.tv_nsec;
 }
 
+double wall_time(void)
+{
+  struct timespec current_time;
+
+  if(clock_gettime(CLOCK_MONOTONIC,&current_time) != 0)
+    return -1.0; // clock_gettime() failed!!!
+  return (double)current_time.tv_sec + 1.0e-9 * (double)current_time.tv_nsec;
+}
+
 #endif
 
 
@@ -55,4 +67,9 @@ double cpu_time(void)
   return (double)current_time.QuadPart / (double)frequency.QuadPart;
 }
 
+double wall_time(void)
+{
+  return cpu_time(); // the performance counter already measures the wall-clock time
+}
+
 #endif